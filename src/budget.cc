@@ -0,0 +1,91 @@
+
+#include "budget.hh"
+#include "stats.hh"
+
+#include <sstream>
+
+namespace lr1cc
+{
+
+    LimitExceeded::LimitExceeded(const std::string &progress, std::size_t states, std::size_t pending)
+        : std::runtime_error { "error: " + progress },
+          m_progress { progress },
+          m_states { states },
+          m_pending { pending }
+    {
+    }
+
+    Budget::Budget(const Limits &limits, std::string_view construction)
+        : m_limits { limits },
+          m_construction { construction },
+          m_start { std::chrono::steady_clock::now() },
+          m_base_rss_kib { limits.max_memory_kib == 0 ? 0 : current_rss_kib() },
+          m_checks { 0 }
+    {
+    }
+
+    void Budget::exceed(std::string_view limit, std::size_t states, std::size_t pending) const
+    {
+        std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - m_start };
+
+        std::ostringstream msg;
+
+        msg << limit
+            << " exceeded in "
+            << m_construction
+            << " construction after "
+            << elapsed.count()
+            << " s: "
+            << states
+            << " states built, "
+            << pending
+            << " pending, "
+            << current_rss_kib()
+            << " KiB resident.\n";
+
+        throw LimitExceeded { msg.str(), states, pending };
+    }
+
+    void Budget::check(std::size_t states, std::size_t pending)
+    {
+        if (m_limits.max_states != 0 && states > m_limits.max_states)
+        {
+            exceed("state limit", states, pending);
+        }
+
+        check_time_and_memory(states, pending);
+    }
+
+    void Budget::check_resources(std::size_t states)
+    {
+        check_time_and_memory(states, 0);
+    }
+
+    void Budget::check_time_and_memory(std::size_t states, std::size_t pending)
+    {
+        ++m_checks;
+
+        if (m_limits.timeout_seconds > 0)
+        {
+            std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - m_start };
+
+            if (elapsed.count() > m_limits.timeout_seconds)
+            {
+                exceed("time limit", states, pending);
+            }
+        }
+
+        // Reading the resident set size costs a system call, so it is
+        // sampled rather than checked on every state.
+        if (m_limits.max_memory_kib != 0 && m_checks % 64 == 0)
+        {
+            auto rss = current_rss_kib();
+
+            if (rss > m_base_rss_kib && rss - m_base_rss_kib > m_limits.max_memory_kib)
+            {
+                exceed("memory limit", states, pending);
+            }
+        }
+    }
+
+}
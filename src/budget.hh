@@ -0,0 +1,89 @@
+#ifndef LR1CC_INCLUDE_BUDGET_HH
+#define LR1CC_INCLUDE_BUDGET_HH
+
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace lr1cc
+{
+
+    // Zero means unlimited.
+    struct Limits
+    {
+        std::size_t max_states = 0;
+        std::size_t max_memory_kib = 0;
+        double timeout_seconds = 0;
+    };
+
+    class LimitExceeded : public std::runtime_error
+    {
+
+        std::string m_progress;
+        std::size_t m_states;
+        std::size_t m_pending;
+
+    public:
+
+        LimitExceeded(const std::string &, std::size_t, std::size_t);
+
+        const std::string &progress() const;
+
+        std::size_t states() const;
+        std::size_t pending() const;
+
+    };
+
+    // Budget is checked by the construction loops once per expanded
+    // state, and by NFA construction once per named state, where only
+    // the time and memory limits apply.  Memory is measured as the growth of the resident set
+    // since the budget was created, so that a retry after a failed
+    // construction starts from a fresh allowance.
+    class Budget
+    {
+
+        Limits m_limits;
+        std::string m_construction;
+        std::chrono::steady_clock::time_point m_start;
+        std::size_t m_base_rss_kib;
+        std::size_t m_checks;
+
+        [[noreturn]] void exceed(std::string_view, std::size_t, std::size_t) const;
+        void check_time_and_memory(std::size_t, std::size_t);
+
+    public:
+
+        Budget(const Limits &, std::string_view);
+
+        const Limits &limits() const;
+
+        void check(std::size_t, std::size_t);
+        void check_resources(std::size_t);
+
+    };
+
+    inline const std::string &LimitExceeded::progress() const
+    {
+        return m_progress;
+    }
+
+    inline std::size_t LimitExceeded::states() const
+    {
+        return m_states;
+    }
+
+    inline std::size_t LimitExceeded::pending() const
+    {
+        return m_pending;
+    }
+
+    inline const Limits &Budget::limits() const
+    {
+        return m_limits;
+    }
+
+}
+
+#endif
@@ -0,0 +1,139 @@
+
+#include "cache.hh"
+#include "util.hh"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <unistd.h>
+
+namespace lr1cc
+{
+
+    static char symbol_type_code(Symbol *s)
+    {
+        return s->is_terminal() ? 't' : 'i';
+    }
+
+    std::string canonical_grammar(const Grammar &g, const SymbolManager &manager, std::string_view options)
+    {
+        std::ostringstream out;
+
+        out << "lr1cc-table 1\n";
+        out << "options " << options << '\n';
+
+        for (Symbol *s : manager.symbols())
+        {
+            if (s->is_useless())
+            {
+                continue;
+            }
+
+            out << "symbol " << symbol_type_code(s) << ' ' << s->name() << '\n';
+        }
+
+        out << "start";
+
+        for (Symbol *s : g.starts())
+        {
+            out << ' ' << s->name();
+        }
+
+        out << (g.starts().empty() ? " \n" : "\n");
+        out << "end " << (g.end() == nullptr ? "" : g.end()->name()) << '\n';
+
+        for (Production *p : g.productions())
+        {
+            out << "production " << p->name << ' ' << p->lhs->name() << " :";
+
+            for (Symbol *s : p->rhs)
+            {
+                out << ' ' << s->name();
+            }
+
+            out << '\n';
+        }
+
+        return out.str();
+    }
+
+    TableCache::TableCache(const std::filesystem::path &directory)
+        : m_directory { directory }
+    {
+    }
+
+    std::filesystem::path TableCache::entry_path(std::string_view key) const
+    {
+        std::ostringstream name;
+
+        name << std::hex << std::setw(16) << std::setfill('0') << fnv1a_hash(key) << ".lr1cc";
+
+        return m_directory / name.str();
+    }
+
+    // An entry holds the length of its key, the key itself and the
+    // table.  The key is compared in full on lookup, so a hash
+    // collision is a miss rather than a wrong table.
+    std::optional<std::string> TableCache::find(std::string_view key) const
+    {
+        std::ifstream in { entry_path(key), std::ios::binary };
+
+        if (!in)
+        {
+            return std::nullopt;
+        }
+
+        std::size_t key_size;
+
+        if (!(in >> key_size) || in.get() != '\n' || key_size != key.size())
+        {
+            return std::nullopt;
+        }
+
+        std::string stored_key(key_size, '\0');
+
+        if (!in.read(stored_key.data(), key_size) || stored_key != key)
+        {
+            return std::nullopt;
+        }
+
+        std::ostringstream table;
+        table << in.rdbuf();
+
+        return table.str();
+    }
+
+    void TableCache::store(std::string_view key, std::string_view table) const
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(m_directory, ec);
+
+        auto path = entry_path(key);
+        auto temp_path = path;
+
+        temp_path += ".tmp" + std::to_string(getpid()) + "-" + std::to_string(std::hash<std::thread::id> {}(std::this_thread::get_id()));
+
+        {
+            std::ofstream out { temp_path, std::ios::binary };
+
+            if (!out)
+            {
+                throw std::runtime_error { "error: failed to write cache entry `" + temp_path.string() + "'.\n" };
+            }
+
+            out << key.size() << '\n' << key << table;
+        }
+
+        std::filesystem::rename(temp_path, path, ec);
+
+        if (ec)
+        {
+            std::filesystem::remove(temp_path, ec);
+        }
+    }
+
+}
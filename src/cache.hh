@@ -0,0 +1,35 @@
+#ifndef LR1CC_INCLUDE_CACHE_HH
+#define LR1CC_INCLUDE_CACHE_HH
+
+#include "symbol.hh"
+#include "grammar.hh"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace lr1cc
+{
+
+    std::string canonical_grammar(const Grammar &, const SymbolManager &, std::string_view);
+
+    class TableCache
+    {
+
+        std::filesystem::path m_directory;
+
+        std::filesystem::path entry_path(std::string_view) const;
+
+    public:
+
+        TableCache(const std::filesystem::path &);
+
+        std::optional<std::string> find(std::string_view) const;
+        void store(std::string_view, std::string_view) const;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,229 @@
+#include "checkpoint.hh"
+#include "util.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace lr1cc
+{
+
+    static constexpr char magic[8] = { 'L', 'R', '1', 'C', 'C', 'C', 'P', '1' };
+
+    Checkpointer::Checkpointer(const std::string &path, std::uint64_t fingerprint, double interval_seconds, bool resume)
+        : m_path { path },
+          m_fingerprint { fingerprint },
+          m_interval { std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double> { interval_seconds }) },
+          m_last { std::chrono::steady_clock::now() },
+          m_resume { resume },
+          m_saves { 0 }
+    {
+    }
+
+    bool Checkpointer::is_due() const
+    {
+        return std::chrono::steady_clock::now() - m_last >= m_interval;
+    }
+
+    class VarintReader
+    {
+
+        const std::string &m_path;
+        const std::string &m_data;
+        std::size_t m_position;
+
+    public:
+
+        VarintReader(const std::string &path, const std::string &data, std::size_t position)
+            : m_path { path },
+              m_data { data },
+              m_position { position }
+        {
+        }
+
+        std::uint64_t get()
+        {
+            std::uint64_t value = 0;
+
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (m_position >= m_data.size())
+                {
+                    break;
+                }
+
+                auto byte = static_cast<unsigned char>(m_data[m_position++]);
+                value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+
+            throw std::runtime_error { "error: checkpoint `" + m_path + "' is truncated.\n" };
+        }
+
+        bool at_end() const
+        {
+            return m_position == m_data.size();
+        }
+
+    };
+
+    // The file is the magic, the fingerprint of the grammar and options,
+    // and then varints: the NFA state count, the DFA state count, the
+    // expanded state count, every state set as sorted deltas, and the
+    // transitions of every expanded state. It is written to a temporary
+    // file and renamed, so a kill while saving keeps the previous one.
+    void Checkpointer::save(const DFACheckpoint &checkpoint)
+    {
+        std::string data { magic, sizeof(magic) };
+
+        put_varint(data, m_fingerprint);
+        put_varint(data, checkpoint.nfa_states);
+        put_varint(data, checkpoint.state_sets.size());
+        put_varint(data, checkpoint.transitions.size());
+
+        for (const auto &set : checkpoint.state_sets)
+        {
+            put_varint(data, set.size());
+
+            std::size_t previous = 0;
+
+            for (std::size_t index : set)
+            {
+                put_varint(data, index - previous);
+                previous = index;
+            }
+        }
+
+        for (const auto &transitions : checkpoint.transitions)
+        {
+            put_varint(data, transitions.size());
+
+            for (auto [ symbol, to_state ] : transitions)
+            {
+                put_varint(data, symbol);
+                put_varint(data, to_state);
+            }
+        }
+
+        auto temporary = m_path + ".tmp";
+
+        {
+            std::ofstream out { temporary, std::ios::binary | std::ios::trunc };
+
+            if (!out || !out.write(data.data(), static_cast<std::streamsize>(data.size())) || !out.flush())
+            {
+                throw std::runtime_error { "error: failed to write checkpoint `" + m_path + "'.\n" };
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temporary, m_path, ec);
+
+        if (ec)
+        {
+            throw std::runtime_error { "error: failed to write checkpoint `" + m_path + "'.\n" };
+        }
+
+        m_last = std::chrono::steady_clock::now();
+        ++m_saves;
+    }
+
+    std::optional<DFACheckpoint> Checkpointer::load() const
+    {
+        std::ifstream in { m_path, std::ios::binary };
+
+        if (!in)
+        {
+            return std::nullopt;
+        }
+
+        std::string data { std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> { } };
+
+        if (data.size() < sizeof(magic) || std::memcmp(data.data(), magic, sizeof(magic)) != 0)
+        {
+            throw std::runtime_error { "error: `" + m_path + "' is not a checkpoint.\n" };
+        }
+
+        VarintReader reader { m_path, data, sizeof(magic) };
+
+        if (reader.get() != m_fingerprint)
+        {
+            throw std::runtime_error { "error: checkpoint `" + m_path + "' was made for another grammar or other options.\n" };
+        }
+
+        auto bounded = [&](std::uint64_t value, std::uint64_t limit) {
+            if (value > limit)
+            {
+                throw std::runtime_error { "error: checkpoint `" + m_path + "' is corrupt.\n" };
+            }
+
+            return static_cast<std::size_t>(value);
+        };
+
+        DFACheckpoint checkpoint;
+
+        checkpoint.nfa_states = bounded(reader.get(), std::numeric_limits<std::size_t>::max());
+
+        auto state_count = bounded(reader.get(), data.size());
+        auto expanded_count = bounded(reader.get(), state_count);
+
+        checkpoint.state_sets.resize(state_count);
+        checkpoint.transitions.resize(expanded_count);
+
+        for (auto &set : checkpoint.state_sets)
+        {
+            set.resize(bounded(reader.get(), std::min(checkpoint.nfa_states, data.size())));
+
+            std::size_t previous = 0;
+
+            for (std::size_t &index : set)
+            {
+                index = bounded(previous + reader.get(), checkpoint.nfa_states - 1);
+                previous = index;
+            }
+        }
+
+        for (auto &transitions : checkpoint.transitions)
+        {
+            transitions.resize(bounded(reader.get(), data.size()));
+
+            for (auto &[ symbol, to_state ] : transitions)
+            {
+                symbol = reader.get();
+                to_state = bounded(reader.get(), state_count - 1);
+            }
+        }
+
+        if (!reader.at_end())
+        {
+            throw std::runtime_error { "error: checkpoint `" + m_path + "' is corrupt.\n" };
+        }
+
+        return checkpoint;
+    }
+
+    std::optional<DFACheckpoint> Checkpointer::resume() const
+    {
+        if (!m_resume)
+        {
+            return std::nullopt;
+        }
+
+        return load();
+    }
+
+    void Checkpointer::remove() const
+    {
+        std::error_code ec;
+        std::filesystem::remove(m_path, ec);
+    }
+
+}
@@ -0,0 +1,58 @@
+#ifndef LR1CC_INCLUDE_CHECKPOINT_HH
+#define LR1CC_INCLUDE_CHECKPOINT_HH
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lr1cc
+{
+
+    // The progress of a canonical LR(1) construction. DFA states are
+    // listed in creation order, and the construction expands them in
+    // that order, so the unexpanded frontier is every state from
+    // `transitions.size()' on. NFA states are indices into NFA::states()
+    // and symbols are Symbol::id()s.
+    struct DFACheckpoint
+    {
+        std::size_t nfa_states;
+        std::vector<std::vector<std::size_t>> state_sets;
+        std::vector<std::vector<std::pair<std::size_t, std::size_t>>> transitions;
+    };
+
+    class Checkpointer
+    {
+
+        std::string m_path;
+        std::uint64_t m_fingerprint;
+        std::chrono::steady_clock::duration m_interval;
+        std::chrono::steady_clock::time_point m_last;
+        bool m_resume;
+        std::size_t m_saves;
+
+    public:
+
+        Checkpointer(const std::string &, std::uint64_t, double, bool);
+
+        bool is_due() const;
+
+        void save(const DFACheckpoint &);
+        std::optional<DFACheckpoint> load() const;
+        std::optional<DFACheckpoint> resume() const;
+        void remove() const;
+
+        std::size_t saves() const;
+
+    };
+
+    inline std::size_t Checkpointer::saves() const
+    {
+        return m_saves;
+    }
+
+}
+
+#endif
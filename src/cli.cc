@@ -1,19 +1,90 @@
 
 #include "cli.hh"
 
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
 namespace lr1cc
 {
 
+    static std::optional<std::size_t> parse_count(std::string_view str)
+    {
+        std::size_t value;
+        auto [ ptr, ec ] = std::from_chars(str.data(), str.data() + str.size(), value);
+
+        if (ec != std::errc {} || ptr != str.data() + str.size() || str.empty())
+        {
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    static std::optional<std::size_t> parse_memory_kib(std::string_view str)
+    {
+        std::size_t unit = 1;
+
+        if (str.ends_with('K'))
+        {
+            str.remove_suffix(1);
+        }
+        else if (str.ends_with('M'))
+        {
+            unit = 1024;
+            str.remove_suffix(1);
+        }
+        else if (str.ends_with('G'))
+        {
+            unit = 1024 * 1024;
+            str.remove_suffix(1);
+        }
+
+        auto value = parse_count(str);
+
+        if (!value.has_value())
+        {
+            return std::nullopt;
+        }
+
+        return value.value() * unit;
+    }
+
+    static std::optional<double> parse_seconds(std::string_view str)
+    {
+        double value;
+        auto [ ptr, ec ] = std::from_chars(str.data(), str.data() + str.size(), value);
+
+        if (ec != std::errc {} || ptr != str.data() + str.size() || str.empty() || value < 0)
+        {
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    static Job default_job(const std::string &input_file, std::string_view suffix = ".csv")
+    {
+        std::string default_output_file { input_file };
+        default_output_file.append(suffix);
+        return Job { input_file, default_output_file };
+    }
+
     std::optional<Config> parse_argv(const std::vector<std::string> &argv)
     {
         std::optional<std::string> output_file;
+        Config conf { { }, false };
 
         std::size_t i = 1;
 
         while (i < argv.size())
         {
-            if (argv[i] == "-o")
+            if (argv[i] == "-o" || argv[i] == "-j" || argv[i] == "--serve")
             {
+                auto option = argv[i];
+
                 ++i;
 
                 if (i >= argv.size())
@@ -21,11 +92,225 @@ namespace lr1cc
                     return std::nullopt;
                 }
 
-                output_file = argv[i];
+                if (option == "-o")
+                {
+                    output_file = argv[i];
+                }
+                else if (option == "--serve")
+                {
+                    conf.serve_socket = argv[i];
+                }
+                else
+                {
+                    auto value = parse_count(argv[i]);
+
+                    if (!value.has_value() || value.value() == 0)
+                    {
+                        return std::nullopt;
+                    }
+
+                    conf.threads = value.value();
+                }
             }
             else if (argv[i] == "-h" || argv[i] == "--help")
             {
-                return Config { "", "", true };
+                return Config { { }, true };
+            }
+            else if (argv[i] == "--stats" || argv[i] == "--stats=text")
+            {
+                conf.stats = StatsFormat::text;
+            }
+            else if (argv[i] == "--stats=json")
+            {
+                conf.stats = StatsFormat::json;
+            }
+            else if (argv[i].starts_with("--max-states="))
+            {
+                auto value = parse_count(std::string_view { argv[i] }.substr(13));
+
+                if (!value.has_value())
+                {
+                    return std::nullopt;
+                }
+
+                conf.limits.max_states = value.value();
+            }
+            else if (argv[i].starts_with("--max-memory="))
+            {
+                auto value = parse_memory_kib(std::string_view { argv[i] }.substr(13));
+
+                if (!value.has_value())
+                {
+                    return std::nullopt;
+                }
+
+                conf.limits.max_memory_kib = value.value();
+            }
+            else if (argv[i].starts_with("--timeout="))
+            {
+                auto value = parse_seconds(std::string_view { argv[i] }.substr(10));
+
+                if (!value.has_value())
+                {
+                    return std::nullopt;
+                }
+
+                conf.limits.timeout_seconds = value.value();
+            }
+            else if (argv[i] == "--construction=lr1")
+            {
+                conf.construction = ConstructionType::lr1;
+            }
+            else if (argv[i] == "--construction=auto")
+            {
+                conf.construction = ConstructionType::automatic;
+            }
+            else if (argv[i] == "--fallback=lalr")
+            {
+                conf.fallback_lalr = true;
+            }
+            else if (argv[i] == "--elide-unit")
+            {
+                conf.elide_unit = true;
+            }
+            else if (argv[i] == "--glr")
+            {
+                conf.glr = true;
+            }
+            else if (argv[i] == "--layout=bfs")
+            {
+                conf.layout = LayoutType::bfs;
+            }
+            else if (argv[i] == "--layout=dfs")
+            {
+                conf.layout = LayoutType::dfs;
+            }
+            else if (argv[i].starts_with("--profile="))
+            {
+                conf.profile_file = argv[i].substr(10);
+                conf.layout = LayoutType::profile;
+
+                if (conf.profile_file.empty())
+                {
+                    return std::nullopt;
+                }
+            }
+            else if (argv[i].starts_with("--recovery="))
+            {
+                conf.recovery_file = argv[i].substr(11);
+
+                if (conf.recovery_file.empty())
+                {
+                    return std::nullopt;
+                }
+            }
+            else if (argv[i].starts_with("--generate="))
+            {
+                auto value = parse_count(std::string_view { argv[i] }.substr(11));
+
+                if (!value.has_value() || value.value() == 0)
+                {
+                    return std::nullopt;
+                }
+
+                conf.generator.tokens = value.value();
+            }
+            else if (argv[i].starts_with("--max-depth="))
+            {
+                auto value = parse_count(std::string_view { argv[i] }.substr(12));
+
+                if (!value.has_value())
+                {
+                    return std::nullopt;
+                }
+
+                conf.generator.max_depth = value.value();
+            }
+            else if (argv[i].starts_with("--seed="))
+            {
+                auto value = parse_count(std::string_view { argv[i] }.substr(7));
+
+                if (!value.has_value())
+                {
+                    return std::nullopt;
+                }
+
+                conf.generator.seed = value.value();
+            }
+            else if (argv[i] == "--coverage")
+            {
+                conf.generator.coverage = true;
+            }
+            else if (argv[i].starts_with("--checkpoint="))
+            {
+                conf.checkpoint_file = argv[i].substr(13);
+
+                if (conf.checkpoint_file.empty())
+                {
+                    return std::nullopt;
+                }
+            }
+            else if (argv[i].starts_with("--checkpoint-interval="))
+            {
+                auto value = parse_seconds(std::string_view { argv[i] }.substr(22));
+
+                if (!value.has_value())
+                {
+                    return std::nullopt;
+                }
+
+                conf.checkpoint_interval = value.value();
+            }
+            else if (argv[i] == "--resume")
+            {
+                conf.resume = true;
+            }
+            else if (argv[i].starts_with("--spill-dir="))
+            {
+                conf.spill_dir = argv[i].substr(12);
+
+                if (conf.spill_dir.empty())
+                {
+                    return std::nullopt;
+                }
+            }
+            else if (argv[i].starts_with("--spill-memory="))
+            {
+                auto value = parse_memory_kib(std::string_view { argv[i] }.substr(15));
+
+                if (!value.has_value())
+                {
+                    return std::nullopt;
+                }
+
+                conf.spill_memory_kib = value.value();
+            }
+            else if (argv[i].starts_with("--cache-dir="))
+            {
+                conf.cache_dir = argv[i].substr(12);
+
+                if (conf.cache_dir.empty())
+                {
+                    return std::nullopt;
+                }
+            }
+            else if (argv[i].starts_with("--serve="))
+            {
+                conf.serve_socket = argv[i].substr(8);
+
+                if (conf.serve_socket.empty())
+                {
+                    return std::nullopt;
+                }
+            }
+            else if (argv[i].starts_with("--manifest="))
+            {
+                conf.manifest_file = argv[i].substr(11);
+
+                if (conf.manifest_file.empty())
+                {
+                    return std::nullopt;
+                }
             }
             else if (argv[i].starts_with("-"))
             {
@@ -39,24 +324,120 @@ namespace lr1cc
             ++i;
         }
 
-        if (i != argv.size() - 1)
+        auto suffix = conf.generator.tokens != 0 ? ".tokens" : ".csv";
+
+        for (; i < argv.size(); ++i)
+        {
+            conf.jobs.push_back(default_job(argv[i], suffix));
+        }
+
+        if (output_file.has_value())
+        {
+            if (conf.jobs.size() != 1 || !conf.manifest_file.empty())
+            {
+                return std::nullopt;
+            }
+
+            conf.jobs.front().output_file = output_file.value();
+        }
+
+        if (conf.glr && conf.elide_unit)
+        {
+            return std::nullopt;
+        }
+
+        if (conf.generator.tokens != 0 && (!conf.serve_socket.empty() || !conf.manifest_file.empty()))
         {
             return std::nullopt;
         }
 
-        std::string input_file = argv[i];
+        if (!conf.spill_dir.empty() && !conf.checkpoint_file.empty())
+        {
+            return std::nullopt;
+        }
 
-        if (output_file.has_value())
+        if (conf.resume && conf.checkpoint_file.empty())
+        {
+            return std::nullopt;
+        }
+
+        if (!conf.checkpoint_file.empty() && (conf.jobs.size() != 1 || !conf.manifest_file.empty() || !conf.serve_socket.empty()))
+        {
+            return std::nullopt;
+        }
+
+        if (!conf.recovery_file.empty() && (conf.jobs.size() != 1 || !conf.manifest_file.empty() || !conf.serve_socket.empty() || !conf.cache_dir.empty() || conf.generator.tokens != 0))
+        {
+            return std::nullopt;
+        }
+
+        if (!conf.serve_socket.empty())
+        {
+            if (!conf.jobs.empty() || !conf.manifest_file.empty() || output_file.has_value())
+            {
+                return std::nullopt;
+            }
+
+            return conf;
+        }
+
+        if (conf.jobs.empty() && conf.manifest_file.empty())
+        {
+            return std::nullopt;
+        }
+
+        return conf;
+    }
+
+    std::vector<Job> read_manifest(const std::string &path)
+    {
+        std::ifstream in { path };
+
+        if (!in)
         {
-            return Config { input_file, output_file.value(), false };
+            throw std::runtime_error { "error: failed to open `" + path + "'.\n" };
         }
-        else
+
+        std::vector<Job> jobs;
+        std::string line;
+
+        while (std::getline(in, line))
         {
-            std::string default_output_file { input_file };
-            default_output_file.append(".csv");
-            return Config { input_file, default_output_file, false };
+            std::istringstream fields { line };
+            std::string input_file, output_file;
+
+            if (!(fields >> input_file) || input_file.starts_with('#'))
+            {
+                continue;
+            }
+
+            auto job = default_job(input_file);
+
+            if (fields >> output_file)
+            {
+                job.output_file = output_file;
+            }
+
+            jobs.push_back(job);
         }
+
+        return jobs;
     }
 
+    std::string table_options(const Config &conf)
+    {
+        std::ostringstream out;
+
+        out << "max-states=" << conf.limits.max_states
+            << " max-memory=" << conf.limits.max_memory_kib
+            << " timeout=" << conf.limits.timeout_seconds
+            << " construction=" << (conf.construction == ConstructionType::automatic ? "auto" : "lr1")
+            << " fallback=" << (conf.fallback_lalr ? "lalr" : "none")
+            << " elide-unit=" << (conf.elide_unit ? "on" : "off")
+            << " glr=" << (conf.glr ? "on" : "off")
+            << " layout=" << (conf.layout == LayoutType::bfs ? "bfs" : conf.layout == LayoutType::dfs ? "dfs" : "profile");
+
+        return out.str();
+    }
     
 }
@@ -1,6 +1,9 @@
 #ifndef LR1CC_INCLUDE_CLI_HH
 #define LR1CC_INCLUDE_CLI_HH
 
+#include "budget.hh"
+#include "generate.hh"
+
 #include <optional>
 #include <string>
 #include <vector>
@@ -8,14 +11,57 @@
 namespace lr1cc
 {
 
-    struct Config
+    enum class StatsFormat
+    {
+        none, text, json
+    };
+
+    enum class LayoutType
+    {
+        bfs, dfs, profile
+    };
+
+    enum class ConstructionType
+    {
+        lr1, automatic
+    };
+
+    struct Job
     {
         std::string input_file;
         std::string output_file;
+    };
+
+    struct Config
+    {
+        std::vector<Job> jobs;
         bool help;
+        StatsFormat stats = StatsFormat::none;
+        Limits limits = {};
+        ConstructionType construction = ConstructionType::lr1;
+        bool fallback_lalr = false;
+        bool elide_unit = false;
+        bool glr = false;
+        LayoutType layout = LayoutType::bfs;
+        std::string profile_file = "";
+        std::string recovery_file = "";
+        std::string checkpoint_file = "";
+        double checkpoint_interval = 300;
+        bool resume = false;
+        std::string spill_dir = "";
+        std::size_t spill_memory_kib = 64 * 1024;
+        std::string cache_dir = "";
+        std::string manifest_file = "";
+        std::size_t threads = 0;
+        std::string serve_socket = "";
+        GeneratorOptions generator = { 0 };
     };
 
     std::optional<Config> parse_argv(const std::vector<std::string> &argv);
+
+    std::vector<Job> read_manifest(const std::string &);
+
+    std::string table_options(const Config &);
     
 }
 
@@ -2,8 +2,12 @@
 #include "conflict.hh"
 
 #include <algorithm>
+#include <deque>
 #include <functional>
 #include <ranges>
+#include <set>
+#include <unordered_set>
+#include <utility>
 
 namespace lr1cc
 {
@@ -20,21 +24,56 @@ namespace lr1cc
             && !state->transitions().empty();
     }
     
-    static void collect_conflicts_of_first(DFAState *first, const std::vector<Symbol *> &first_path, std::vector<Conflict> &conflicts)
+    // Like for_each_dfa_state_with_path, but a final state, which is
+    // shared by every state reducing by the same production, is visited
+    // once per lookahead it is reached on, so each lookahead leading to a
+    // reduction is reported as if the reduction had its own state.
+    template <typename Func>
+    static void for_each_lookahead_with_path(DFAState *state, Func func)
+    {
+        std::unordered_set<DFAState *> visited { state };
+        std::set<std::pair<DFAState *, Symbol *>> visited_finals;
+        std::deque<std::pair<DFAState *, std::vector<Symbol *>>> queue { std::pair { state, std::vector<Symbol *> { } } };
+
+        while (!queue.empty())
+        {
+            auto [ s, path ] = queue.front();
+            queue.pop_front();
+
+            func(s, path);
+
+            for (const auto &[ input, to_state ] : s->transitions())
+            {
+                bool unvisited = !to_state->rejects() && to_state->transitions().empty()
+                    ? visited_finals.emplace(to_state, input).second
+                    : visited.emplace(to_state).second;
+
+                if (unvisited)
+                {
+                    std::vector new_path { path };
+                    new_path.push_back(input);
+
+                    queue.push_back(std::pair { to_state, new_path });
+                }
+            }
+        }
+    }
+
+    static void collect_conflicts_of_first(DFAState *first, const std::vector<Symbol *> &first_path, std::size_t entry, std::vector<Conflict> &conflicts)
     {
         if (has_reduce_reduce_conflict(first))
         {
-            conflicts.push_back(Conflict { first, first, first_path, std::vector<Symbol *> { } });
+            conflicts.push_back(Conflict { first, first, first_path, std::vector<Symbol *> { }, entry });
         }
 
         if (has_shift_reduce_conflict(first))
         {
-            for_each_dfa_state_with_path(
+            for_each_lookahead_with_path(
                 first,
                 [&](DFAState *second, const std::vector<Symbol *> &second_path) {
                     if (!second->rejects() && first != second)
                     {
-                        conflicts.push_back(Conflict { first, second, first_path, second_path });
+                        conflicts.push_back(Conflict { first, second, first_path, second_path, entry });
                     }
                 });
         }
@@ -45,12 +84,52 @@ namespace lr1cc
         std::vector<Conflict> conflicts;
 
         for_each_dfa_state_with_path(
-            dfa.start(),
-            [&](DFAState *state, const std::vector<Symbol *> &path) {
-                collect_conflicts_of_first(state, path, conflicts);
+            dfa.starts(),
+            [&](DFAState *state, const std::vector<Symbol *> &path, std::size_t entry) {
+                collect_conflicts_of_first(state, path, entry, conflicts);
             });
 
         return conflicts;
     }
+
+    bool has_conflicts(const DFA &dfa)
+    {
+        return std::ranges::any_of(
+            dfa.states(),
+            [](DFAState *state) {
+                return has_reduce_reduce_conflict(state) || has_shift_reduce_conflict(state);
+            });
+    }
+
+    // Whether no state that reduces also shifts, goes to another state
+    // or reduces by another production; the table would then be the
+    // same with the reductions on every terminal.
+    bool is_lr0(const DFA &dfa)
+    {
+        for (DFAState *state : dfa.states())
+        {
+            std::set<Production *> reductions;
+            bool moves = false;
+
+            for (const auto &[ input, to_state ] : state->transitions())
+            {
+                if (to_state->reductions().empty())
+                {
+                    moves = true;
+                }
+                else
+                {
+                    reductions.insert(to_state->reductions().cbegin(), to_state->reductions().cend());
+                }
+            }
+
+            if (!reductions.empty() && (moves || reductions.size() > 1))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
     
 }
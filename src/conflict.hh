@@ -12,9 +12,15 @@ namespace lr1cc
         DFAState *second_state;
         std::vector<Symbol *> start_to_first;
         std::vector<Symbol *> first_to_second;
+        // The index of the start symbol from whose entry state
+        // start_to_first leads.
+        std::size_t entry;
     };
 
     std::vector<Conflict> collect_conflicts(const DFA &);
+
+    bool has_conflicts(const DFA &);
+    bool is_lr0(const DFA &);
     
 }
 
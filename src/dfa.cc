@@ -2,39 +2,40 @@
 #include "dfa.hh"
 #include "util.hh"
 
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <optional>
+#include <stdexcept>
 #include <unordered_map>
 
 namespace lr1cc
 {
 
     DFA::DFA()
-        : m_start { nullptr }
     {
     }
 
     DFA::DFA(DFA &&dfa)
-        : m_start { dfa.m_start },
+        : m_starts { std::move(dfa.m_starts) },
           m_states { std::move(dfa.m_states) }
     {
-        dfa.m_start = nullptr;
+        dfa.m_starts.clear();
     }
 
     DFA &DFA::operator=(DFA &&dfa)
     {
-        m_start = dfa.m_start;
+        m_starts = std::move(dfa.m_starts);
         m_states = std::move(dfa.m_states);
 
-        dfa.m_start = nullptr;
+        dfa.m_starts.clear();
         
         return *this;
     }
 
-    using NFAStatesDFAStateAssociation = std::unordered_map<std::set<NFAState *>, DFAState *, SetHash<NFAState *>>;
-    
-    static std::set<Symbol *> nfa_states_inputs(const std::set<NFAState *> &nstates)
+    template <typename Set>
+    static void collect_inputs(const std::set<NFAState *> &nstates, Set &inputs)
     {
-        std::set<Symbol *> inputs;
-
         for (NFAState *state : nstates)
         {
             for (const auto &pair : state->transitions())
@@ -44,29 +45,81 @@ namespace lr1cc
         }
 
         inputs.erase(nullptr);
+    }
+
+    std::set<Symbol *, SymbolLess> nfa_states_inputs(const std::set<NFAState *> &nstates)
+    {
+        std::set<Symbol *, SymbolLess> inputs;
+
+        collect_inputs(nstates, inputs);
         
         return inputs;
     }
 
-    static DFAState *get_dfa_state(const std::set<NFAState *> &nstates, DFA &dfa, NFAStatesDFAStateAssociation &nfa_to_dfa)
+    std::pmr::set<Symbol *, SymbolLess> nfa_states_inputs(const std::set<NFAState *> &nstates, std::pmr::memory_resource *resource)
+    {
+        std::pmr::set<Symbol *, SymbolLess> inputs { resource };
+
+        collect_inputs(nstates, inputs);
+
+        return inputs;
+    }
+
+    std::vector<std::set<NFAState *>> initial_state_sets(const NFA &nfa)
     {
+        std::vector<std::set<NFAState *>> sets;
+
+        for (NFAState *start : nfa.starts())
+        {
+            std::set<NFAState *> nstates { start };
+            epsilon_close(nstates);
+
+            sets.push_back(std::move(nstates));
+        }
+
+        return sets;
+    }
+
+    using DFAStateList = std::vector<std::pair<const std::set<NFAState *> *, DFAState *>>;
+
+    static std::set<NFAState *> own_state_set(std::set<NFAState *> &&nstates)
+    {
+        return std::move(nstates);
+    }
+
+    static std::set<NFAState *> own_state_set(std::pmr::set<NFAState *> &&nstates)
+    {
+        return std::set<NFAState *> { nstates.cbegin(), nstates.cend() };
+    }
+
+    template <typename Set>
+    static DFAState *get_dfa_state(Set &&nstates, DFA &dfa, NFAStatesDFAStateAssociation &nfa_to_dfa, FinalStateCatalog &finals, DFAStateList &dstates)
+    {
+        auto action = sole_action(nstates);
+
+        if (action.has_value())
+        {
+            auto final_iter = finals.find(action.value());
+
+            if (final_iter != finals.end())
+            {
+                return final_iter->second;
+            }
+        }
+
         auto iter = nfa_to_dfa.find(nstates);
 
         if (iter == nfa_to_dfa.end())
         {
             auto dstate = dfa.create_state(nstates);
 
-            nfa_to_dfa.emplace(nstates, dstate);
+            auto inserted = nfa_to_dfa.emplace(own_state_set(std::move(nstates)), dstate).first;
 
-            auto inputs = nfa_states_inputs(nstates);
+            dstates.push_back(std::pair { &inserted->first, dstate });
 
-            for (Symbol *input : inputs)
+            if (action.has_value())
             {
-                auto to_nstates = transit(nstates, input);
-                    
-                auto to_dstate = get_dfa_state(to_nstates, dfa, nfa_to_dfa);
-                    
-                dstate->transitions().emplace(input, to_dstate);
+                finals.emplace(action.value(), dstate);
             }
 
             return dstate;
@@ -76,19 +129,422 @@ namespace lr1cc
             return iter->second;
         }
     }
-    
-    DFA nfa_to_dfa(const NFA &nfa)
+
+    static DFACheckpoint make_checkpoint(const NFA &nfa, const DFAStateList &dstates, std::size_t expanded)
+    {
+        std::unordered_map<NFAState *, std::size_t> nfa_index;
+
+        for (NFAState *nstate : nfa.states())
+        {
+            nfa_index.emplace(nstate, nfa_index.size());
+        }
+
+        std::unordered_map<DFAState *, std::size_t> dfa_index;
+
+        for (const auto &pair : dstates)
+        {
+            dfa_index.emplace(pair.second, dfa_index.size());
+        }
+
+        DFACheckpoint checkpoint { nfa_index.size(), { }, { } };
+
+        for (const auto &[ nstates, dstate ] : dstates)
+        {
+            auto &set = checkpoint.state_sets.emplace_back();
+
+            for (NFAState *nstate : *nstates)
+            {
+                set.push_back(nfa_index.at(nstate));
+            }
+
+            std::ranges::sort(set);
+        }
+
+        for (std::size_t i = 0; i < expanded; ++i)
+        {
+            auto &transitions = checkpoint.transitions.emplace_back();
+
+            for (const auto &[ input, to_dstate ] : dstates[i].second->transitions())
+            {
+                transitions.emplace_back(input->id(), dfa_index.at(to_dstate));
+            }
+        }
+
+        return checkpoint;
+    }
+
+    static std::size_t restore_checkpoint(const DFACheckpoint &checkpoint, const NFA &nfa, DFA &dfa, NFAStatesDFAStateAssociation &nfa_to_dfa, FinalStateCatalog &finals, DFAStateList &dstates)
+    {
+        std::vector<NFAState *> nstates { nfa.states().begin(), nfa.states().end() };
+        std::unordered_map<std::size_t, Symbol *> symbols;
+
+        for (NFAState *nstate : nstates)
+        {
+            for (const auto &pair : nstate->transitions())
+            {
+                if (pair.first != nullptr)
+                {
+                    symbols.emplace(pair.first->id(), pair.first);
+                }
+            }
+        }
+
+        auto mismatch = []() {
+            return std::runtime_error { "error: checkpoint does not match the automaton being built.\n" };
+        };
+
+        if (checkpoint.nfa_states != nstates.size())
+        {
+            throw mismatch();
+        }
+
+        for (const auto &indices : checkpoint.state_sets)
+        {
+            std::set<NFAState *> set;
+
+            for (std::size_t index : indices)
+            {
+                set.emplace(nstates[index]);
+            }
+
+            get_dfa_state(std::move(set), dfa, nfa_to_dfa, finals, dstates);
+        }
+
+        if (dstates.size() != checkpoint.state_sets.size())
+        {
+            throw mismatch();
+        }
+
+        for (std::size_t i = 0; i < checkpoint.transitions.size(); ++i)
+        {
+            for (auto [ symbol, to_state ] : checkpoint.transitions[i])
+            {
+                auto iter = symbols.find(symbol);
+
+                if (iter == symbols.end())
+                {
+                    throw mismatch();
+                }
+
+                dstates[i].second->transitions().emplace(iter->second, dstates[to_state].second);
+            }
+        }
+
+        return checkpoint.transitions.size();
+    }
+
+    // States are expanded in the order they are created, so the
+    // expanded ones are always a prefix of `dstates'.
+    DFA nfa_to_dfa(const NFA &nfa, HashTableStats *stats, Budget *budget, Checkpointer *checkpointer)
     {
         DFA dfa;
         
         NFAStatesDFAStateAssociation nfa_to_dfa;
+        FinalStateCatalog finals;
+        DFAStateList dstates;
+        ScratchMemory scratch;
+        std::size_t expanded = 0;
 
-        std::set initial_nstates { nfa.start() };
-        epsilon_close(initial_nstates);
-        
-        auto initial_dstate = get_dfa_state(initial_nstates, dfa, nfa_to_dfa);
+        auto checkpoint = checkpointer != nullptr ? checkpointer->resume() : std::nullopt;
+
+        if (checkpoint.has_value() && !checkpoint->state_sets.empty())
+        {
+            expanded = restore_checkpoint(checkpoint.value(), nfa, dfa, nfa_to_dfa, finals, dstates);
+        }
+        else
+        {
+            for (auto &initial_nstates : initial_state_sets(nfa))
+            {
+                get_dfa_state(std::move(initial_nstates), dfa, nfa_to_dfa, finals, dstates);
+            }
+        }
+
+        checkpoint.reset();
+
+        for (std::size_t i = 0; i < nfa.starts().size(); ++i)
+        {
+            dfa.add_start(dstates[i].second);
+        }
+
+        while (expanded < dstates.size())
+        {
+            auto [ nstates, dstate ] = dstates[expanded];
+
+            if (budget != nullptr)
+            {
+                try
+                {
+                    budget->check(nfa_to_dfa.size(), dstates.size() - expanded - 1);
+                }
+                catch (LimitExceeded &)
+                {
+                    if (checkpointer != nullptr)
+                    {
+                        checkpointer->save(make_checkpoint(nfa, dstates, expanded));
+                    }
+
+                    throw;
+                }
+            }
+
+            for (Symbol *input : nfa_states_inputs(*nstates, scratch.resource()))
+            {
+                auto to_dstate = get_dfa_state(transit(*nstates, input, scratch.resource()), dfa, nfa_to_dfa, finals, dstates);
+
+                dstate->transitions().emplace(input, to_dstate);
+            }
+
+            scratch.reset();
+            ++expanded;
+
+            if (checkpointer != nullptr && checkpointer->is_due())
+            {
+                checkpointer->save(make_checkpoint(nfa, dstates, expanded));
+            }
+        }
 
-        dfa.set_start(initial_dstate);
+        if (stats != nullptr)
+        {
+            *stats = hash_table_stats(nfa_to_dfa);
+        }
+
+        return dfa;
+    }
+
+    template <typename Set>
+    static void encode_state_set(const Set &nstates, const std::unordered_map<NFAState *, std::uint32_t> &nfa_index, std::vector<std::uint32_t> &indices, std::string &out)
+    {
+        indices.clear();
+
+        for (NFAState *nstate : nstates)
+        {
+            indices.push_back(nfa_index.at(nstate));
+        }
+
+        std::ranges::sort(indices);
+
+        out.clear();
+
+        std::uint32_t previous = 0;
+
+        for (std::uint32_t index : indices)
+        {
+            put_varint(out, index - previous);
+            previous = index;
+        }
+    }
+
+    static std::set<NFAState *> decode_state_set(std::string_view bytes, const std::vector<NFAState *> &nstates)
+    {
+        std::set<NFAState *> set;
+        std::uint64_t index = 0;
+        std::uint64_t delta = 0;
+        int shift = 0;
+
+        for (char ch : bytes)
+        {
+            auto byte = static_cast<unsigned char>(ch);
+            delta |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            shift += 7;
+
+            if ((byte & 0x80) == 0)
+            {
+                index += delta;
+                set.emplace_hint(set.end(), nstates[index]);
+                delta = 0;
+                shift = 0;
+            }
+        }
+
+        return set;
+    }
+
+    // The same construction as above with the state sets kept in a
+    // StateSetStore. Only the set being expanded and its successors are
+    // decoded at a time; the unexpanded frontier is the tail of the
+    // store.
+    DFA nfa_to_dfa(const NFA &nfa, StateSetStore &store, Budget *budget)
+    {
+        DFA dfa;
+
+        std::vector<NFAState *> nstates { nfa.states().begin(), nfa.states().end() };
+        std::unordered_map<NFAState *, std::uint32_t> nfa_index;
+
+        for (NFAState *nstate : nstates)
+        {
+            nfa_index.emplace(nstate, static_cast<std::uint32_t>(nfa_index.size()));
+        }
+
+        FinalStateCatalog finals;
+        std::vector<DFAState *> dstates;
+        std::vector<std::uint32_t> indices;
+        std::string encoded;
+        ScratchMemory scratch;
+
+        auto get_spilled_dfa_state = [&](const auto &set) {
+            auto action = sole_action(set);
+
+            if (action.has_value() && finals.contains(action.value()))
+            {
+                return finals.at(action.value());
+            }
+
+            encode_state_set(set, nfa_index, indices, encoded);
+
+            auto [ id, inserted ] = store.intern(encoded);
+
+            if (inserted)
+            {
+                dstates.push_back(dfa.create_state(set));
+
+                if (action.has_value())
+                {
+                    finals.emplace(action.value(), dstates.back());
+                }
+            }
+
+            return dstates[id];
+        };
+
+        for (const auto &initial_nstates : initial_state_sets(nfa))
+        {
+            dfa.add_start(get_spilled_dfa_state(initial_nstates));
+        }
+
+        for (std::size_t expanded = 0; expanded < dstates.size(); ++expanded)
+        {
+            if (budget != nullptr)
+            {
+                budget->check(dstates.size(), dstates.size() - expanded - 1);
+            }
+
+            auto set = decode_state_set(store.get(expanded), nstates);
+            auto dstate = dstates[expanded];
+
+            for (Symbol *input : nfa_states_inputs(set, scratch.resource()))
+            {
+                dstate->transitions().emplace(input, get_spilled_dfa_state(transit(set, input, scratch.resource())));
+            }
+
+            scratch.reset();
+        }
+
+        return dfa;
+    }
+
+    using CoreSet = std::set<std::size_t>;
+
+    struct LALRState
+    {
+        std::set<NFAState *> nstates;
+        std::map<Symbol *, std::size_t, SymbolLess> transitions;
+    };
+
+    using CoreLALRStateAssociation = std::unordered_map<CoreSet, std::size_t, SetHash<std::size_t>, SetEqual>;
+
+    template <typename Set>
+    static std::pmr::set<std::size_t> nfa_states_cores(const Set &nstates, std::pmr::memory_resource *resource)
+    {
+        std::pmr::set<std::size_t> cores { resource };
+
+        for (NFAState *state : nstates)
+        {
+            cores.emplace(state->core());
+        }
+
+        return cores;
+    }
+
+    template <typename Set>
+    static std::size_t get_lalr_state(Set &&nstates, std::vector<LALRState> &states, CoreLALRStateAssociation &core_to_state, std::deque<std::size_t> &queue, std::pmr::memory_resource *resource)
+    {
+        auto cores = nfa_states_cores(nstates, resource);
+        auto iter = core_to_state.find(cores);
+
+        if (iter == core_to_state.end())
+        {
+            auto index = states.size();
+
+            states.push_back(LALRState { own_state_set(std::move(nstates)), {} });
+            core_to_state.emplace(CoreSet { cores.cbegin(), cores.cend() }, index);
+            queue.push_back(index);
+
+            return index;
+        }
+
+        auto &merged = states[iter->second].nstates;
+        auto prev_size = merged.size();
+
+        merged.insert(nstates.cbegin(), nstates.cend());
+
+        if (merged.size() != prev_size)
+        {
+            queue.push_back(iter->second);
+        }
+
+        return iter->second;
+    }
+
+    DFA nfa_to_lalr_dfa(const NFA &nfa, HashTableStats *stats, Budget *budget)
+    {
+        std::vector<LALRState> states;
+        CoreLALRStateAssociation core_to_state;
+        std::deque<std::size_t> queue;
+        ScratchMemory scratch;
+
+        for (auto &initial_nstates : initial_state_sets(nfa))
+        {
+            get_lalr_state(std::move(initial_nstates), states, core_to_state, queue, scratch.resource());
+        }
+
+        scratch.reset();
+
+        while (!queue.empty())
+        {
+            auto index = queue.front();
+            queue.pop_front();
+
+            if (budget != nullptr)
+            {
+                budget->check(states.size(), queue.size());
+            }
+
+            for (Symbol *input : nfa_states_inputs(states[index].nstates, scratch.resource()))
+            {
+                auto to_nstates = transit(states[index].nstates, input, scratch.resource());
+                auto to_index = get_lalr_state(std::move(to_nstates), states, core_to_state, queue, scratch.resource());
+
+                states[index].transitions.insert_or_assign(input, to_index);
+            }
+
+            scratch.reset();
+        }
+
+        DFA dfa;
+        std::vector<DFAState *> dstates;
+
+        for (const LALRState &state : states)
+        {
+            dstates.push_back(dfa.create_state(state.nstates));
+        }
+
+        for (std::size_t i = 0; i < states.size(); ++i)
+        {
+            for (const auto &pair : states[i].transitions)
+            {
+                dstates[i]->transitions().emplace(pair.first, dstates[pair.second]);
+            }
+        }
+
+        for (std::size_t i = 0; i < nfa.starts().size(); ++i)
+        {
+            dfa.add_start(dstates[i]);
+        }
+
+        if (stats != nullptr)
+        {
+            *stats = hash_table_stats(core_to_state);
+        }
 
         return dfa;
     }
@@ -4,12 +4,19 @@
 #include "symbol.hh"
 #include "grammar.hh"
 #include "nfa.hh"
+#include "budget.hh"
+#include "checkpoint.hh"
+#include "spill.hh"
+#include "util.hh"
 
 #include <deque>
 #include <map>
 #include <memory>
+#include <optional>
 #include <ranges>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -19,7 +26,7 @@ namespace lr1cc
 
     class DFAState;
 
-    using DFATransitionCatalog = std::map<Symbol *, DFAState *>;
+    using DFATransitionCatalog = std::map<Symbol *, DFAState *, SymbolLess>;
     
     class DFAState
     {
@@ -51,16 +58,22 @@ namespace lr1cc
         
     };
 
+    template <typename Func>
+    void for_each_dfa_state(const std::vector<DFAState *> &states, Func func);
+
     template <typename Func>
     void for_each_dfa_state(DFAState *state, Func func);
 
+    template <typename Func>
+    void for_each_dfa_state_with_path(const std::vector<DFAState *> &states, Func func);
+
     template <typename Func>
     void for_each_dfa_state_with_path(DFAState *state, Func func);
     
     class DFA
     {
 
-        DFAState *m_start;
+        std::vector<DFAState *> m_starts;
         std::vector<std::unique_ptr<DFAState>> m_states;
         
     public:
@@ -76,18 +89,70 @@ namespace lr1cc
         DFAState *start() const;
         void set_start(DFAState *);
 
+        const std::vector<DFAState *> &starts() const;
+        void add_start(DFAState *);
+
         template <typename R>
         requires std::ranges::input_range<std::remove_reference_t<R>>
         DFAState *create_state(R &&);
 
+        auto states() const;
+
         template <typename R>
         requires std::ranges::input_range<std::remove_reference_t<R>>
         DFAState *run(R &&) const;
         
     };
 
-    DFA nfa_to_dfa(const NFA &);
+    using NFAStatesDFAStateAssociation = std::unordered_map<std::set<NFAState *>, DFAState *, SetHash<NFAState *>, SetEqual>;
+
+    using FinalStateCatalog = std::unordered_map<Production *, DFAState *>;
+
+    template <typename R>
+    requires std::ranges::input_range<std::remove_reference_t<R>>
+    std::optional<Production *> sole_action(R &&);
+
+    std::set<Symbol *, SymbolLess> nfa_states_inputs(const std::set<NFAState *> &);
+    std::pmr::set<Symbol *, SymbolLess> nfa_states_inputs(const std::set<NFAState *> &, std::pmr::memory_resource *);
+
+    // The closures of the entry states of the NFA, in the order of the
+    // start symbols; they become the first states of the DFA.
+    std::vector<std::set<NFAState *>> initial_state_sets(const NFA &);
+
+    DFA nfa_to_dfa(const NFA &, HashTableStats * = nullptr, Budget * = nullptr, Checkpointer * = nullptr);
+    DFA nfa_to_dfa(const NFA &, StateSetStore &, Budget * = nullptr);
+    DFA nfa_to_lalr_dfa(const NFA &, HashTableStats * = nullptr, Budget * = nullptr);
     
+    // A set of final NFA states has no transitions, so it only stands
+    // for its action. Sets that take one action, accepting (nullptr) or
+    // reducing by one production, share a DFA state per action; sets in
+    // conflict keep their own state for the conflict report.
+    template <typename R>
+    requires std::ranges::input_range<std::remove_reference_t<R>>
+    std::optional<Production *> sole_action(R &&nstates)
+    {
+        std::optional<Production *> action;
+
+        for (NFAState *nstate : nstates)
+        {
+            const auto &acceptance = nstate->acceptance();
+
+            if (acceptance.type == AcceptanceType::reject || !nstate->transitions().empty())
+            {
+                return std::nullopt;
+            }
+
+            if (action.has_value() && action.value() != acceptance.production)
+            {
+                return std::nullopt;
+            }
+
+            action = acceptance.production;
+        }
+
+        return action;
+    }
+
     template <typename R>
     requires std::ranges::input_range<std::remove_reference_t<R>>
     bool nfa_states_accept(R &&r)
@@ -153,12 +218,22 @@ namespace lr1cc
 
     inline DFAState *DFA::start() const
     {
-        return m_start;
+        return m_starts.empty() ? nullptr : m_starts.front();
     }
 
     inline void DFA::set_start(DFAState *s)
     {
-        m_start = s;
+        m_starts = { s };
+    }
+
+    inline const std::vector<DFAState *> &DFA::starts() const
+    {
+        return m_starts;
+    }
+
+    inline void DFA::add_start(DFAState *s)
+    {
+        m_starts.push_back(s);
     }
 
     template <typename R>
@@ -173,11 +248,20 @@ namespace lr1cc
         return raw_ptr;
     }
 
+    inline auto DFA::states() const
+    {
+        auto raw_pointer = [](const std::unique_ptr<DFAState> &p) {
+            return p.get();
+        };
+
+        return m_states | std::ranges::views::transform(raw_pointer);
+    }
+
     template <typename R>
     requires std::ranges::input_range<std::remove_reference_t<R>>
     DFAState *DFA::run(R &&r) const
     {
-        auto state = m_start;
+        auto state = start();
 
         for (Symbol *input : r)
         {
@@ -197,12 +281,14 @@ namespace lr1cc
         return state;
     }
 
+    // Both searches are breadth-first from all of `states' at once, so
+    // every state is visited once, from the first of them that reaches
+    // it in the fewest transitions.
     template <typename Func>
-    void for_each_dfa_state(DFAState *state, Func func)
+    void for_each_dfa_state(const std::vector<DFAState *> &states, Func func)
     {
-        std::unordered_set<DFAState *> visited { state };
-        std::deque<DFAState *> queue;
-        queue.push_back(state);
+        std::unordered_set<DFAState *> visited { states.begin(), states.end() };
+        std::deque<DFAState *> queue { states.begin(), states.end() };
 
         while (!queue.empty())
         {
@@ -223,18 +309,30 @@ namespace lr1cc
     }
 
     template <typename Func>
-    void for_each_dfa_state_with_path(DFAState *state, Func func)
+    void for_each_dfa_state(DFAState *state, Func func)
     {
-        std::unordered_set<DFAState *> visited { state };
-        std::deque<std::pair<DFAState *, std::vector<Symbol *>>> queue;
-        queue.push_back(std::pair { state, std::vector<Symbol *> { } });
+        for_each_dfa_state(std::vector { state }, func);
+    }
+
+    // `func' is called with the state, the path to it and the index in
+    // `states' of the state the path starts from.
+    template <typename Func>
+    void for_each_dfa_state_with_path(const std::vector<DFAState *> &states, Func func)
+    {
+        std::unordered_set<DFAState *> visited { states.begin(), states.end() };
+        std::deque<std::tuple<DFAState *, std::vector<Symbol *>, std::size_t>> queue;
+
+        for (std::size_t i = 0; i < states.size(); ++i)
+        {
+            queue.push_back(std::tuple { states[i], std::vector<Symbol *> { }, i });
+        }
 
         while (!queue.empty())
         {
-            auto [ state, path ] = queue.front();
+            auto [ state, path, entry ] = queue.front();
             queue.pop_front();
 
-            func(state, path);
+            func(state, path, entry);
 
             for (const auto &pair : state->transitions())
             {
@@ -245,11 +343,21 @@ namespace lr1cc
                     std::vector new_path { path };
                     new_path.push_back(pair.first);
                     
-                    queue.push_back(std::pair { pair.second, new_path });
+                    queue.push_back(std::tuple { pair.second, new_path, entry });
                 }
             }
         }
     }
+
+    template <typename Func>
+    void for_each_dfa_state_with_path(DFAState *state, Func func)
+    {
+        for_each_dfa_state_with_path(
+            std::vector { state },
+            [&](DFAState *s, const std::vector<Symbol *> &path, std::size_t) {
+                func(s, path);
+            });
+    }
     
 }
 
@@ -0,0 +1,640 @@
+
+#include "driver.hh"
+#include "grammar.hh"
+#include "nfa.hh"
+#include "dfa.hh"
+#include "conflict.hh"
+#include "elide.hh"
+#include "generate.hh"
+#include "cache.hh"
+#include "checkpoint.hh"
+#include "input.hh"
+#include "layout.hh"
+#include "mapped-file.hh"
+#include "module.hh"
+#include "output.hh"
+#include "recovery.hh"
+#include "stats.hh"
+#include "table.hh"
+#include "util.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace lr1cc
+{
+
+    static void output_conflict_point(const std::vector<Symbol *> &symbols, std::string_view point, std::ostream &out)
+    {
+        for (std::size_t i = 0; i < symbols.size() - 1; ++i)
+        {
+            out << symbols[i]->name() << ' ';
+        }
+
+        out << point << ' ';
+
+        out << symbols[symbols.size() - 1]->name();
+    }
+
+    static void output_actions(DFAState *state, std::ostream &out)
+    {
+        if (state->accepts())
+        {
+            out << " *ACCEPT*";
+        }
+
+        for (Production *p : state->reductions())
+        {
+            out << ' ' << p->name;
+        }
+    }
+
+    static void report_sr_conflict(const Conflict &conflict, std::ostream &out)
+    {
+        output_conflict_point(conflict.start_to_first, "[1]", out);
+
+        out << ' ';
+
+        output_conflict_point(conflict.first_to_second, "[2]", out);
+
+        out << '\n';
+
+        out << "[1]:";
+        output_actions(conflict.first_state, out);
+
+        out << "\n[2]:";
+        output_actions(conflict.second_state, out);
+
+        out << "\n\n";
+    }
+
+    static void report_rr_conflict(const Conflict &conflict, std::ostream &out)
+    {
+        output_conflict_point(conflict.start_to_first, "[1]", out);
+
+        out << '\n';
+
+        out << "[1]:";
+        output_actions(conflict.first_state, out);
+
+        out << "\n\n";
+    }
+
+    // With several start symbols, the path to the conflict is preceded
+    // by the start symbol it is parsed from.
+    void report_conflict(const Conflict &conflict, const Grammar &g, std::ostream &out)
+    {
+        if (g.starts().size() > 1)
+        {
+            out << g.starts()[conflict.entry]->name() << ": ";
+        }
+
+        if (conflict.first_state == conflict.second_state)
+        {
+            report_rr_conflict(conflict, out);
+        }
+        else
+        {
+            report_sr_conflict(conflict, out);
+        }
+    }
+
+    void report_conflicts(const std::vector<Conflict> &conflicts, const Grammar &g, std::ostream &out)
+    {
+        for (const Conflict &conflict : conflicts)
+        {
+            report_conflict(conflict, g, out);
+        }
+    }
+
+    void report_reduction(const GrammarReduction &reduction, std::ostream &out)
+    {
+        for (Symbol *s : reduction.unproductive)
+        {
+            out << "warning: symbol `" << s->name() << "' derives no terminal string; removed.\n";
+        }
+
+        for (Symbol *s : reduction.unreachable)
+        {
+            out << "warning: symbol `" << s->name() << "' is unreachable from the start symbol; removed.\n";
+        }
+
+        for (Production *p : reduction.removed)
+        {
+            if (!p->lhs->is_useless())
+            {
+                out << "warning: production [" << p->name << "] uses a useless symbol; removed.\n";
+            }
+        }
+
+        out << std::flush;
+    }
+
+    static void report_stats(const Config &conf, Stats &stats, std::ostream &report)
+    {
+        stats.peak_rss_kib = peak_rss_kib();
+
+        if (conf.stats == StatsFormat::text)
+        {
+            output_stats(stats, report);
+        }
+        else if (conf.stats == StatsFormat::json)
+        {
+            output_stats_json(stats, report);
+        }
+    }
+
+    // Symbol ids are assigned before the grammar is reduced, so the
+    // fingerprint lists every symbol, useless or not, in id order.
+    static std::uint64_t checkpoint_fingerprint(const Grammar &g, const SymbolManager &manager)
+    {
+        std::string key = canonical_grammar(g, manager, "");
+
+        for (Symbol *s : manager.symbols())
+        {
+            key += "id " + std::to_string(s->id()) + ' ' + s->name() + '\n';
+        }
+
+        return fnv1a_hash(key);
+    }
+
+    AutomatonBuild build_automaton(const Config &conf, const Grammar &g, const SymbolManager &manager, Stats &stats, Stopwatch &stopwatch, std::ostream &diagnostics)
+    {
+        NFA nfa;
+        DFA dfa;
+
+        // The SLR(1) automaton is as small as the LR(0) one; when it has
+        // no conflicts, its table parses the same language as the LR(1)
+        // one. Elision relies on exact LR(1) lookaheads, so it always
+        // takes the LR(1) path.
+        if (conf.construction == ConstructionType::automatic && !conf.elide_unit)
+        {
+            nfa = grammar_to_slr_nfa(g);
+
+            Budget budget { conf.limits, "SLR(1)" };
+            dfa = nfa_to_dfa(nfa, &stats.dfa_states, &budget);
+
+            if (has_conflicts(dfa))
+            {
+                diagnostics << "note: the grammar is not SLR(1); using LR(1) construction.\n" << std::flush;
+            }
+            else
+            {
+                auto lr0 = is_lr0(dfa);
+
+                diagnostics << "note: the grammar is " << (lr0 ? "LR(0)" : "SLR(1)") << "; using SLR(1) construction.\n";
+
+                // Checkpoints and spill files only cover the LR(1)
+                // subset construction.
+                if (!conf.checkpoint_file.empty())
+                {
+                    diagnostics << "note: --checkpoint and --resume are ignored by SLR(1) construction.\n";
+                }
+
+                if (!conf.spill_dir.empty())
+                {
+                    diagnostics << "note: --spill-dir is ignored by SLR(1) construction.\n";
+                }
+
+                diagnostics << std::flush;
+                stats.construction = lr0 ? "lr0" : "slr";
+            }
+
+            stats.phases.push_back(stopwatch.lap("slr"));
+        }
+
+        if (stats.construction.empty())
+        {
+            // The limits cover the NFA too, whose growth can dominate
+            // for grammars with many lookaheads. A limit reached there
+            // is not retried: LALR(1) construction needs the same NFA.
+            Budget budget { conf.limits, "LR(1)" };
+
+            nfa = grammar_to_nfa(g, &stats.named_states, &budget);
+            stats.phases.push_back(stopwatch.lap("nfa"));
+
+            std::optional<Checkpointer> checkpointer;
+
+            if (!conf.checkpoint_file.empty())
+            {
+                checkpointer.emplace(conf.checkpoint_file, checkpoint_fingerprint(g, manager), conf.checkpoint_interval, conf.resume);
+
+                if (conf.resume && !std::filesystem::exists(conf.checkpoint_file))
+                {
+                    diagnostics << "note: no checkpoint found; starting from the beginning.\n" << std::flush;
+                }
+            }
+
+            try
+            {
+                if (conf.spill_dir.empty())
+                {
+                    dfa = nfa_to_dfa(nfa, &stats.dfa_states, &budget, checkpointer.has_value() ? &checkpointer.value() : nullptr);
+                }
+                else
+                {
+                    StateSetStore store { conf.spill_dir, conf.spill_memory_kib * 1024 };
+                    dfa = nfa_to_dfa(nfa, store, &budget);
+                }
+
+                stats.construction = "lr1";
+
+                if (checkpointer.has_value())
+                {
+                    checkpointer->remove();
+                }
+            }
+            catch (LimitExceeded &e)
+            {
+                if (!conf.fallback_lalr)
+                {
+                    throw;
+                }
+
+                diagnostics << "warning: " << e.progress()
+                            << "note: retrying with LALR(1) construction.\n" << std::flush;
+
+                Budget budget { conf.limits, "LALR(1)" };
+                dfa = nfa_to_lalr_dfa(nfa, &stats.dfa_states, &budget);
+                stats.construction = "lalr";
+            }
+
+            stats.phases.push_back(stopwatch.lap("dfa"));
+        }
+
+        auto conflicts = collect_conflicts(dfa);
+        stats.phases.push_back(stopwatch.lap("conflicts"));
+
+        if (conf.stats != StatsFormat::none)
+        {
+            stats.nfa = nfa_stats(nfa);
+            stats.dfa = dfa_stats(dfa);
+        }
+
+        return AutomatonBuild { std::move(dfa), std::move(conflicts) };
+
+    }
+
+    TableLayout build_layout(const Config &conf, DFA &dfa, const std::vector<Symbol *> &columns, const Profile *profile, Stats &stats, Stopwatch &stopwatch)
+    {
+        if (conf.elide_unit)
+        {
+            elide_unit_reductions(dfa);
+            stats.phases.push_back(stopwatch.lap("elide"));
+        }
+
+        ensure_no_unnamed_reductions(dfa);
+
+        return conf.layout == LayoutType::dfs ? dfs_layout(dfa, columns)
+            : conf.layout == LayoutType::profile ? profile_layout(dfa, columns, *profile)
+            : bfs_layout(dfa, columns);
+    }
+
+    static Profile load_profile(const std::string &path, std::uint64_t &hash)
+    {
+        std::ifstream in { path, std::ios::binary };
+
+        if (!in)
+        {
+            throw std::runtime_error { "error: failed to open `" + path + "'.\n" };
+        }
+
+        std::ostringstream content;
+        content << in.rdbuf();
+
+        hash = fnv1a_hash(content.view());
+
+        std::istringstream profile_in { content.str() };
+        return read_profile(profile_in);
+    }
+
+    static BuildStatus build_table(const Config &conf, std::string_view input_name, std::string_view in, ModuleCache &modules, std::vector<ModuleSource> &sources, std::ostream &out, std::ostream &diagnostics, std::ostream &report)
+    {
+        SymbolManager manager;
+        std::vector<std::unique_ptr<Production>> productions;
+        Stats stats {};
+        Stopwatch stopwatch;
+
+        stats.input = input_name;
+
+        auto g = parse_input(in, std::string { input_name }, modules, sources, manager, productions);
+        stats.phases.push_back(stopwatch.lap("parse"));
+
+        g.calculate();
+        g.ensure_sanity();
+        stats.phases.push_back(stopwatch.lap("first"));
+
+        report_reduction(g.reduce(manager), diagnostics);
+        stats.phases.push_back(stopwatch.lap("reduce"));
+
+        std::optional<Profile> profile;
+        std::string options = table_options(conf);
+
+        if (conf.layout == LayoutType::profile)
+        {
+            std::uint64_t hash;
+            profile = load_profile(conf.profile_file, hash);
+
+            options += " profile=" + std::to_string(hash);
+        }
+
+        std::optional<TableCache> cache;
+        std::string cache_key;
+
+        if (!conf.cache_dir.empty())
+        {
+            cache.emplace(conf.cache_dir);
+            cache_key = canonical_grammar(g, manager, options);
+
+            auto table = cache->find(cache_key);
+
+            if (table.has_value())
+            {
+                out << table.value() << std::flush;
+                stats.construction = "cache";
+                stats.phases.push_back(stopwatch.lap("cache"));
+
+                report_stats(conf, stats, report);
+                return BuildStatus::success;
+            }
+        }
+        
+        auto [ dfa, conflicts ] = build_automaton(conf, g, manager, stats, stopwatch, diagnostics);
+
+        if (!conflicts.empty() && conf.glr)
+        {
+            diagnostics << "warning: " << conflicts.size()
+                        << (conflicts.size() == 1 ? " conflict" : " conflicts")
+                        << " detected; all actions are kept for GLR parsing.\n";
+
+            report_conflicts(conflicts, g, diagnostics);
+
+            diagnostics << std::flush;
+        }
+        else if (!conflicts.empty())
+        {
+            diagnostics << conflicts.size()
+                        << (conflicts.size() == 1 ? " conflict" : " conflicts")
+                        << " detected.\n";
+            
+            report_conflicts(conflicts, g, diagnostics);
+            
+            diagnostics << std::flush;
+
+            report_stats(conf, stats, report);
+            return BuildStatus::conflict;
+        }
+
+        auto columns = table_columns(manager);
+        auto layout = build_layout(conf, dfa, columns, profile.has_value() ? &profile.value() : nullptr, stats, stopwatch);
+        std::optional<ParseTable> glr_table;
+
+        auto output_table = [&](std::ostream &out) {
+            if (conf.glr)
+            {
+                glr_table.emplace(layout);
+                output_parse_table(glr_table.value(), out);
+            }
+            else
+            {
+                output_lr1_table(layout, out);
+            }
+        };
+
+        if (cache.has_value())
+        {
+            std::ostringstream table { std::ios::binary };
+
+            output_table(table);
+
+            out << table.view() << std::flush;
+            cache->store(cache_key, table.view());
+        }
+        else
+        {
+            output_table(out);
+        }
+
+        if (!conf.recovery_file.empty())
+        {
+            std::ofstream recovery_out { conf.recovery_file, std::ios::binary };
+
+            if (!recovery_out)
+            {
+                throw std::runtime_error { "error: failed to open `" + conf.recovery_file + "'.\n" };
+            }
+
+            std::optional<ParseTable> lr1_table;
+            const ParseTable &table = glr_table.has_value() ? glr_table.value() : lr1_table.emplace(layout);
+
+            output_recovery_table(table, RecoveryTable { table }, recovery_out);
+        }
+
+        stats.phases.push_back(stopwatch.lap("output"));
+
+        if (conf.stats != StatsFormat::none)
+        {
+            stats.table = glr_table.has_value()
+                ? parse_table_stats(glr_table.value())
+                : lr1_table_stats(layout);
+            report_stats(conf, stats, report);
+        }
+
+        return BuildStatus::success;
+    }
+
+    BuildStatus build_grammar(const Config &conf, std::string_view input_name, std::string_view in, ModuleCache &modules, std::vector<ModuleSource> &sources, std::ostream &out, std::ostream &diagnostics, std::ostream &report)
+    {
+        try
+        {
+            return build_table(conf, input_name, in, modules, sources, out, diagnostics, report);
+        }
+        catch (std::ios_base::failure &e)
+        {
+            diagnostics << "error: I/O failed." << std::endl;
+            return BuildStatus::failure;
+        }
+        catch (std::runtime_error &e)
+        {
+            diagnostics << e.what() << std::flush;
+            return BuildStatus::failure;
+        }
+    }
+
+    int build(const Config &conf, const Job &job, ModuleCache &modules, std::ostream &diagnostics, std::ostream &report)
+    {
+        std::optional<MappedFile> in;
+
+        try
+        {
+            in.emplace(job.input_file);
+        }
+        catch (std::runtime_error &e)
+        {
+            diagnostics << e.what() << std::flush;
+            return 1;
+        }
+
+        std::ofstream out { job.output_file, std::ios::binary };
+
+        if (!out)
+        {
+            diagnostics << "error: failed to open `" << job.output_file << "'." << std::endl;
+            return 1;
+        }
+
+        std::vector<ModuleSource> sources;
+
+        auto status = build_grammar(conf, job.input_file, in->view(), modules, sources, out, diagnostics, report);
+
+        return status == BuildStatus::success ? 0 : 1;
+    }
+
+    int build(const Config &conf, const Job &job, std::ostream &diagnostics, std::ostream &report)
+    {
+        ModuleCache modules;
+
+        return build(conf, job, modules, diagnostics, report);
+    }
+
+    struct JobResult
+    {
+        int status;
+        std::ostringstream diagnostics;
+        std::ostringstream report;
+    };
+
+    // Every job owns its SymbolManager, Grammar and output buffers, so
+    // workers share nothing but the index of the next job and the cache
+    // of included modules.
+    int build_all(const Config &conf, const std::vector<Job> &jobs, std::ostream &diagnostics, std::ostream &report)
+    {
+        if (jobs.size() == 1)
+        {
+            return build(conf, jobs.front(), diagnostics, report);
+        }
+
+        ModuleCache modules;
+        std::vector<JobResult> results(jobs.size());
+        std::atomic<std::size_t> next_job { 0 };
+
+        auto worker = [&]() {
+            while (true)
+            {
+                auto i = next_job.fetch_add(1);
+
+                if (i >= jobs.size())
+                {
+                    break;
+                }
+
+                results[i].status = build(conf, jobs[i], modules, results[i].diagnostics, results[i].report);
+            }
+        };
+
+        auto thread_count = conf.threads != 0
+            ? conf.threads
+            : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+        thread_count = std::min(thread_count, jobs.size());
+
+        std::vector<std::jthread> threads;
+
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+
+        threads.clear();
+
+        int status = 0;
+
+        for (std::size_t i = 0; i < jobs.size(); ++i)
+        {
+            if (!results[i].diagnostics.view().empty())
+            {
+                diagnostics << jobs[i].input_file << ":\n" << results[i].diagnostics.view();
+            }
+
+            report << results[i].report.view();
+
+            status = std::max(status, results[i].status);
+        }
+
+        diagnostics << std::flush;
+        report << std::flush;
+
+        return status;
+    }
+
+    int generate(const Config &conf, const Job &job, std::ostream &diagnostics)
+    {
+        try
+        {
+            MappedFile in { job.input_file };
+            std::ofstream out { job.output_file, std::ios::binary };
+
+            if (!out)
+            {
+                diagnostics << "error: failed to open `" << job.output_file << "'." << std::endl;
+                return 1;
+            }
+
+            ModuleCache modules;
+            std::vector<ModuleSource> sources;
+            SymbolManager manager;
+            std::vector<std::unique_ptr<Production>> productions;
+
+            auto g = parse_input(in.view(), job.input_file, modules, sources, manager, productions);
+            g.calculate();
+            g.ensure_sanity();
+
+            report_reduction(g.reduce(manager), diagnostics);
+
+            auto columns = table_columns(manager);
+
+            // The dfs and profile layouts reorder the columns, so the
+            // tokens are numbered after the table the same options build.
+            if (conf.layout != LayoutType::bfs)
+            {
+                std::optional<Profile> profile;
+
+                if (conf.layout == LayoutType::profile)
+                {
+                    std::uint64_t hash;
+                    profile = load_profile(conf.profile_file, hash);
+                }
+
+                Stats stats {};
+                Stopwatch stopwatch;
+
+                auto automaton = build_automaton(conf, g, manager, stats, stopwatch, diagnostics);
+                columns = build_layout(conf, automaton.dfa, columns, profile.has_value() ? &profile.value() : nullptr, stats, stopwatch).columns;
+            }
+
+            SentenceGenerator generator { g, conf.generator };
+            write_token_stream(generator, columns, out);
+        }
+        catch (std::ios_base::failure &e)
+        {
+            diagnostics << "error: I/O failed." << std::endl;
+            return 1;
+        }
+        catch (std::runtime_error &e)
+        {
+            diagnostics << e.what() << std::flush;
+            return 1;
+        }
+
+        return 0;
+    }
+
+}
@@ -0,0 +1,45 @@
+#ifndef LR1CC_INCLUDE_DRIVER_HH
+#define LR1CC_INCLUDE_DRIVER_HH
+
+#include "cli.hh"
+#include "conflict.hh"
+#include "layout.hh"
+#include "module.hh"
+#include "stats.hh"
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace lr1cc
+{
+
+    enum class BuildStatus { success, failure, conflict };
+
+    struct AutomatonBuild
+    {
+        DFA dfa;
+        std::vector<Conflict> conflicts;
+    };
+
+    // The phases of a build between the reduced grammar and the table,
+    // shared by the command line and build_table in library.hh.
+    AutomatonBuild build_automaton(const Config &, const Grammar &, const SymbolManager &, Stats &, Stopwatch &, std::ostream &);
+    TableLayout build_layout(const Config &, DFA &, const std::vector<Symbol *> &, const Profile *, Stats &, Stopwatch &);
+
+    void report_conflict(const Conflict &, const Grammar &, std::ostream &);
+    void report_conflicts(const std::vector<Conflict> &, const Grammar &, std::ostream &);
+    void report_reduction(const GrammarReduction &, std::ostream &);
+
+    BuildStatus build_grammar(const Config &, std::string_view, std::string_view, ModuleCache &, std::vector<ModuleSource> &, std::ostream &, std::ostream &, std::ostream &);
+
+    int build(const Config &, const Job &, ModuleCache &, std::ostream &, std::ostream &);
+    int build(const Config &, const Job &, std::ostream &, std::ostream &);
+
+    int build_all(const Config &, const std::vector<Job> &, std::ostream &, std::ostream &);
+
+    int generate(const Config &, const Job &, std::ostream &);
+
+}
+
+#endif
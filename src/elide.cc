@@ -0,0 +1,307 @@
+
+#include "elide.hh"
+
+#include <deque>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace lr1cc
+{
+
+    bool is_elidable(const Production *p)
+    {
+        return p->name.empty()
+            && p->rhs.size() == 1
+            && p->rhs.front()->is_intermediate();
+    }
+
+    static Production *unit_reduction(DFAState *to_state)
+    {
+        if (to_state->accepts()
+            || to_state->reductions().size() != 1
+            || !to_state->transitions().empty())
+        {
+            return nullptr;
+        }
+
+        auto p = *to_state->reductions().begin();
+
+        return is_elidable(p) ? p : nullptr;
+    }
+
+    class UnitElider
+    {
+
+        using Key = std::vector<DFAState *>;
+
+        DFA &m_dfa;
+        std::map<std::pair<DFAState *, Symbol *>, DFAState *> m_resolved;
+        std::set<std::pair<DFAState *, Symbol *>> m_active;
+        std::map<Key, DFAState *> m_merged;
+
+    public:
+
+        explicit UnitElider(DFA &dfa)
+            : m_dfa { dfa }
+        {
+        }
+
+        DFAState *resolve(DFAState *, Symbol *);
+
+    };
+
+    // Resolves goto(p, x). If the target q reduces A -> x on some
+    // lookaheads, the reduction would pop back to p and continue in
+    // goto(p, A); the result is then a state that acts like q but takes
+    // the actions of the resolved goto(p, A) on those lookaheads, and
+    // the gotos of both. q itself is kept when the gotos disagree.
+    DFAState *UnitElider::resolve(DFAState *p, Symbol *x)
+    {
+        auto memo = m_resolved.find(std::pair { p, x });
+
+        if (memo != m_resolved.end())
+        {
+            return memo->second;
+        }
+
+        auto q = p->transitions().at(x);
+
+        std::map<Symbol *, DFAState *, SymbolLess> lhs_states;
+
+        for (const auto &[ input, to_state ] : q->transitions())
+        {
+            auto unit = input->is_terminal() ? unit_reduction(to_state) : nullptr;
+
+            if (unit != nullptr)
+            {
+                lhs_states.emplace(unit->lhs, nullptr);
+            }
+        }
+
+        if (lhs_states.empty())
+        {
+            return m_resolved[std::pair { p, x }] = q;
+        }
+
+        m_active.emplace(p, x);
+
+        for (auto &[ lhs, state ] : lhs_states)
+        {
+            if (m_active.contains(std::pair { p, lhs }) || !p->transitions().contains(lhs))
+            {
+                m_active.erase(std::pair { p, x });
+                return q;
+            }
+
+            state = resolve(p, lhs);
+        }
+
+        m_active.erase(std::pair { p, x });
+
+        Key key { q };
+
+        for (const auto &pair : lhs_states)
+        {
+            key.push_back(pair.second);
+        }
+
+        auto merged = m_merged.find(key);
+
+        if (merged != m_merged.end())
+        {
+            return m_resolved[std::pair { p, x }] = merged->second;
+        }
+
+        DFATransitionCatalog transitions;
+
+        auto add_transition = [&](Symbol *input, DFAState *to_state) {
+            auto [ iter, inserted ] = transitions.emplace(input, to_state);
+            return inserted || iter->second == to_state;
+        };
+
+        bool consistent = true;
+
+        for (const auto &[ input, to_state ] : q->transitions())
+        {
+            auto unit = input->is_terminal() ? unit_reduction(to_state) : nullptr;
+
+            if (unit == nullptr)
+            {
+                consistent = consistent && add_transition(input, to_state);
+                continue;
+            }
+
+            auto lhs_state = lhs_states.at(unit->lhs);
+            auto iter = lhs_state->transitions().find(input);
+
+            consistent = consistent
+                && iter != lhs_state->transitions().end()
+                && add_transition(input, iter->second);
+        }
+
+        for (const auto &[ lhs, lhs_state ] : lhs_states)
+        {
+            for (const auto &[ input, to_state ] : lhs_state->transitions())
+            {
+                if (input->is_intermediate())
+                {
+                    consistent = consistent && add_transition(input, to_state);
+                }
+            }
+        }
+
+        if (!consistent)
+        {
+            return m_resolved[std::pair { p, x }] = q;
+        }
+
+        auto r = m_dfa.create_state(std::vector<NFAState *> { });
+        r->transitions() = std::move(transitions);
+
+        m_merged.emplace(std::move(key), r);
+
+        return m_resolved[std::pair { p, x }] = r;
+    }
+
+    using StateSignature = std::vector<std::tuple<Symbol *, DFAState *, bool, Production *>>;
+
+    static StateSignature state_signature(DFAState *state)
+    {
+        StateSignature signature;
+
+        for (const auto &[ input, to_state ] : state->transitions())
+        {
+            if (to_state->rejects() || !to_state->transitions().empty() || to_state->reductions().size() > 1)
+            {
+                signature.emplace_back(input, to_state, false, nullptr);
+            }
+            else
+            {
+                auto p = to_state->reductions().empty() ? nullptr : *to_state->reductions().begin();
+                signature.emplace_back(input, nullptr, to_state->accepts(), p);
+            }
+        }
+
+        return signature;
+    }
+
+    // Merged states of a cascade often end up with identical rows;
+    // they are folded into one until no two rows are alike.
+    static void merge_identical_states(DFA &dfa)
+    {
+        while (true)
+        {
+            std::map<StateSignature, DFAState *> representatives;
+            std::unordered_map<DFAState *, DFAState *> replacements;
+            std::vector<DFAState *> states;
+
+            for_each_dfa_state(dfa.starts(), [&](DFAState *state) {
+                if (!state->rejects())
+                {
+                    return;
+                }
+
+                states.push_back(state);
+
+                auto representative = representatives.emplace(state_signature(state), state).first->second;
+
+                if (representative != state)
+                {
+                    replacements.emplace(state, representative);
+                }
+            });
+
+            if (replacements.empty())
+            {
+                break;
+            }
+
+            for (DFAState *state : states)
+            {
+                for (auto &pair : state->transitions())
+                {
+                    auto iter = replacements.find(pair.second);
+
+                    if (iter != replacements.end())
+                    {
+                        pair.second = iter->second;
+                    }
+                }
+            }
+        }
+    }
+
+    // Every goto is replaced by its resolved state, including the gotos
+    // of merged states. States left without predecessors drop out of
+    // the table.
+    std::size_t elide_unit_reductions(DFA &dfa)
+    {
+        UnitElider elider { dfa };
+
+        std::unordered_set<DFAState *> visited { dfa.starts().begin(), dfa.starts().end() };
+        std::deque<DFAState *> queue { dfa.starts().begin(), dfa.starts().end() };
+
+        std::size_t elided = 0;
+
+        while (!queue.empty())
+        {
+            auto state = queue.front();
+            queue.pop_front();
+
+            for (auto &[ input, to_state ] : state->transitions())
+            {
+                if (input->is_intermediate())
+                {
+                    auto resolved = elider.resolve(state, input);
+
+                    if (resolved != to_state)
+                    {
+                        to_state = resolved;
+                        ++elided;
+                    }
+                }
+
+                if (to_state->rejects() && visited.emplace(to_state).second)
+                {
+                    queue.push_back(to_state);
+                }
+            }
+        }
+
+        if (elided != 0)
+        {
+            merge_identical_states(dfa);
+        }
+
+        return elided;
+    }
+
+    void ensure_no_unnamed_reductions(const DFA &dfa)
+    {
+        for_each_dfa_state(dfa.starts(), [&](DFAState *state) {
+            for (Production *p : state->reductions())
+            {
+                if (p->name.empty())
+                {
+                    std::ostringstream msg;
+
+                    msg << "error: reduction by unnamed production `"
+                        << p->lhs->name()
+                        << ": "
+                        << p->rhs.front()->name()
+                        << "' remains in the table.\n";
+
+                    throw std::runtime_error { msg.str() };
+                }
+            }
+        });
+    }
+
+}
@@ -0,0 +1,18 @@
+#ifndef LR1CC_INCLUDE_ELIDE_HH
+#define LR1CC_INCLUDE_ELIDE_HH
+
+#include "dfa.hh"
+#include "grammar.hh"
+
+namespace lr1cc
+{
+
+    bool is_elidable(const Production *);
+
+    std::size_t elide_unit_reductions(DFA &);
+
+    void ensure_no_unnamed_reductions(const DFA &);
+
+}
+
+#endif
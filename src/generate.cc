@@ -0,0 +1,180 @@
+#include "generate.hh"
+
+#include <algorithm>
+#include <limits>
+#include <ranges>
+
+namespace lr1cc
+{
+
+    static constexpr std::size_t infinity = std::numeric_limits<std::size_t>::max();
+
+    static std::size_t saturating_add(std::size_t a, std::size_t b)
+    {
+        return a > infinity - b ? infinity : a + b;
+    }
+
+    SentenceGenerator::SentenceGenerator(const Grammar &g, const GeneratorOptions &options)
+        : m_grammar { g },
+          m_options { options },
+          m_random { options.seed }
+    {
+        for (Production *p : g.productions())
+        {
+            auto &rule = m_rules.try_emplace(p->lhs, Rule { { }, infinity, infinity }).first->second;
+            rule.alternatives.push_back(Alternative { p, { }, infinity, infinity, 0 });
+        }
+
+        for (auto &[ lhs, rule ] : m_rules)
+        {
+            for (Alternative &alternative : rule.alternatives)
+            {
+                for (Symbol *s : alternative.production->rhs)
+                {
+                    auto iter = m_rules.find(s);
+                    alternative.rhs.push_back(iter == m_rules.end() ? nullptr : &iter->second);
+                }
+            }
+        }
+
+        bool changed = true;
+
+        while (changed)
+        {
+            changed = false;
+
+            for (auto &[ lhs, rule ] : m_rules)
+            {
+                for (Alternative &alternative : rule.alternatives)
+                {
+                    std::size_t length = 0;
+                    std::size_t height = 0;
+
+                    for (const Rule *child : alternative.rhs)
+                    {
+                        length = saturating_add(length, child == nullptr ? 1 : child->min_length);
+                        height = std::max(height, child == nullptr ? 0 : child->min_height);
+                    }
+
+                    alternative.length = length;
+                    alternative.height = saturating_add(height, 1);
+
+                    if (alternative.length < rule.min_length)
+                    {
+                        rule.min_length = alternative.length;
+                        changed = true;
+                    }
+
+                    if (alternative.height < rule.min_height)
+                    {
+                        rule.min_height = alternative.height;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    std::size_t SentenceGenerator::uses(const Production *p) const
+    {
+        auto iter = m_rules.find(p->lhs);
+
+        if (iter == m_rules.end())
+        {
+            return 0;
+        }
+
+        for (const Alternative &alternative : iter->second.alternatives)
+        {
+            if (alternative.production == p)
+            {
+                return alternative.uses;
+            }
+        }
+
+        return 0;
+    }
+
+    // Taking the PRNG output modulo the count, unlike the standard
+    // distributions, gives the same streams with every library.
+    SentenceGenerator::Alternative &SentenceGenerator::choose(Rule &rule, bool forced, std::size_t room)
+    {
+        m_candidates.clear();
+
+        if (!forced)
+        {
+            for (Alternative &alternative : rule.alternatives)
+            {
+                if (alternative.length <= room)
+                {
+                    m_candidates.push_back(&alternative);
+                }
+            }
+        }
+
+        if (m_candidates.empty())
+        {
+            for (Alternative &alternative : rule.alternatives)
+            {
+                if (alternative.height == rule.min_height)
+                {
+                    m_candidates.push_back(&alternative);
+                }
+            }
+        }
+
+        if (m_options.coverage)
+        {
+            auto least_uses = std::ranges::min(
+                m_candidates | std::ranges::views::transform([](Alternative *a) { return a->uses; }));
+
+            std::erase_if(
+                m_candidates,
+                [&](Alternative *a) {
+                    return a->uses != least_uses;
+                });
+        }
+
+        return *m_candidates[m_random() % m_candidates.size()];
+    }
+
+    // Every token is written as the 32-bit little-endian index of its
+    // column in the parsing table.
+    std::size_t write_token_stream(SentenceGenerator &generator, const std::vector<Symbol *> &columns, std::ostream &out)
+    {
+        std::vector<std::uint32_t> column_index;
+
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            column_index.resize(std::max(column_index.size(), columns[i]->id() + 1));
+            column_index[columns[i]->id()] = static_cast<std::uint32_t>(i);
+        }
+
+        constexpr std::size_t buffer_size = 64 * 1024;
+
+        std::vector<char> buffer(buffer_size);
+        std::size_t used = 0;
+
+        auto count = generator.generate(
+            [&](Symbol *s) {
+                auto index = column_index[s->id()];
+
+                buffer[used++] = static_cast<char>(index & 0xff);
+                buffer[used++] = static_cast<char>((index >> 8) & 0xff);
+                buffer[used++] = static_cast<char>((index >> 16) & 0xff);
+                buffer[used++] = static_cast<char>((index >> 24) & 0xff);
+
+                if (used == buffer_size)
+                {
+                    out.write(buffer.data(), static_cast<std::streamsize>(used));
+                    used = 0;
+                }
+            });
+
+        out.write(buffer.data(), static_cast<std::streamsize>(used));
+        out << std::flush;
+
+        return count;
+    }
+
+}
@@ -0,0 +1,162 @@
+#ifndef LR1CC_INCLUDE_GENERATE_HH
+#define LR1CC_INCLUDE_GENERATE_HH
+
+#include "grammar.hh"
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace lr1cc
+{
+
+    struct GeneratorOptions
+    {
+        std::size_t tokens;
+        std::size_t max_depth = 64;
+        std::uint64_t seed = 1;
+        bool coverage = false;
+    };
+
+    // Derives sentences of the grammar from a seeded PRNG until the
+    // requested number of tokens (End-Of-Tokens included) is reached.
+    // Below `max_depth' and while the token budget allows, alternatives
+    // are picked at random (or least used first for coverage); past it,
+    // only alternatives of minimal derivation height are taken, so every
+    // sentence is finite.
+    class SentenceGenerator
+    {
+
+        struct Rule;
+
+        struct Alternative
+        {
+            Production *production;
+            std::vector<Rule *> rhs;
+            std::size_t length;
+            std::size_t height;
+            std::size_t uses;
+        };
+
+        struct Rule
+        {
+            std::vector<Alternative> alternatives;
+            std::size_t min_length;
+            std::size_t min_height;
+        };
+
+        struct Pending
+        {
+            Symbol *symbol;
+            Rule *rule;
+            std::size_t depth;
+        };
+
+        const Grammar &m_grammar;
+        GeneratorOptions m_options;
+        std::mt19937_64 m_random;
+        std::unordered_map<Symbol *, Rule> m_rules;
+        std::vector<Alternative *> m_candidates;
+
+        Alternative &choose(Rule &, bool, std::size_t);
+
+    public:
+
+        SentenceGenerator(const Grammar &, const GeneratorOptions &);
+
+        SentenceGenerator(const SentenceGenerator &) = delete;
+        SentenceGenerator &operator=(const SentenceGenerator &) = delete;
+
+        std::size_t min_length(Symbol *) const;
+        std::size_t min_height(Symbol *) const;
+        std::size_t uses(const Production *) const;
+
+        template <typename Func>
+        std::size_t generate_sentence(std::size_t, Func);
+
+        template <typename Func>
+        std::size_t generate(Func);
+
+    };
+
+    std::size_t write_token_stream(SentenceGenerator &, const std::vector<Symbol *> &, std::ostream &);
+
+    inline std::size_t SentenceGenerator::min_length(Symbol *s) const
+    {
+        return s->is_terminal() ? 1 : m_rules.at(s).min_length;
+    }
+
+    inline std::size_t SentenceGenerator::min_height(Symbol *s) const
+    {
+        return s->is_terminal() ? 0 : m_rules.at(s).min_height;
+    }
+
+    template <typename Func>
+    std::size_t SentenceGenerator::generate_sentence(std::size_t budget, Func emit)
+    {
+        Symbol *start = m_grammar.start();
+        std::vector<Pending> stack { Pending { start, &m_rules.at(start), 0 } };
+        std::size_t pending_length = min_length(start);
+        std::size_t count = 0;
+        std::size_t steps = 0;
+        std::size_t max_steps = 16 * budget + 1024;
+
+        while (!stack.empty())
+        {
+            auto [ symbol, rule, depth ] = stack.back();
+            stack.pop_back();
+
+            if (rule == nullptr)
+            {
+                --pending_length;
+                emit(symbol);
+                ++count;
+                continue;
+            }
+
+            pending_length -= rule->min_length;
+
+            auto used = count + pending_length;
+            auto room = budget > used ? budget - used : 0;
+            auto forced = depth >= m_options.max_depth || ++steps > max_steps;
+
+            auto &alternative = choose(*rule, forced, room);
+            ++alternative.uses;
+
+            const auto &rhs = alternative.production->rhs;
+
+            for (std::size_t i = rhs.size(); i-- > 0;)
+            {
+                auto child = alternative.rhs[i];
+
+                stack.push_back(Pending { rhs[i], child, depth + 1 });
+                pending_length += child == nullptr ? 1 : child->min_length;
+            }
+        }
+
+        return count;
+    }
+
+    template <typename Func>
+    std::size_t SentenceGenerator::generate(Func emit)
+    {
+        std::size_t count = 0;
+
+        while (count < m_options.tokens)
+        {
+            auto budget = m_options.tokens - count - 1;
+
+            count += generate_sentence(budget, emit);
+
+            emit(m_grammar.end());
+            ++count;
+        }
+
+        return count;
+    }
+
+}
+
+#endif
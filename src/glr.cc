@@ -0,0 +1,399 @@
+#include "glr.hh"
+#include "util.hh"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+namespace lr1cc
+{
+
+    struct StackNode;
+
+    struct StackEdge
+    {
+        StackNode *to;
+        ForestNode *tree;
+    };
+
+    struct StackNode
+    {
+        std::size_t state;
+        std::size_t level;
+        bool processed;
+        std::vector<StackEdge> edges;
+    };
+
+    struct StackPath
+    {
+        StackNode *bottom;
+        std::vector<ForestNode *> trees;
+    };
+
+    // One level of the graph-structured stack: the tops that have read
+    // input[0, position) and are about to act on input[position].
+    class GLRLevel
+    {
+
+        const ParseTable &m_table;
+        Forest &m_forest;
+        std::deque<StackNode> &m_nodes;
+        std::size_t m_entry;
+        std::size_t m_position;
+        Symbol *m_input;
+        std::vector<StackNode *> m_tops;
+        std::vector<std::pair<StackNode *, std::size_t>> m_shifts;
+        std::unordered_map<std::pair<Symbol *, std::size_t>, ForestNode *, PairHash<Symbol *, std::size_t>> m_trees;
+        ForestNode *m_root;
+
+        StackNode *find_top(std::size_t) const;
+        ForestNode *tree(Symbol *, std::size_t);
+
+        void act(StackNode *);
+        void reduce(const StackPath &, const Production *);
+        void add_edge(StackNode *, StackNode *, ForestNode *);
+
+    public:
+
+        GLRLevel(const ParseTable &, Forest &, std::deque<StackNode> &, std::size_t, std::size_t, Symbol *, std::vector<StackNode *>);
+
+        void run();
+
+        ForestNode *root() const;
+        std::vector<StackNode *> shift();
+
+    };
+
+    // Every path of `length' edges down from `node'; with `via', only
+    // those that pass through that edge leaving `via_from'.
+    static std::vector<StackPath> paths_from(StackNode *node, std::size_t length, StackNode *via_from = nullptr, const StackEdge *via = nullptr)
+    {
+        std::vector<StackPath> paths;
+        std::vector<ForestNode *> trees;
+
+        auto walk = [&](auto &self, StackNode *n, std::size_t rest, bool passed) -> void {
+            if (rest == 0)
+            {
+                if (passed)
+                {
+                    paths.push_back(StackPath { n, { trees.rbegin(), trees.rend() } });
+                }
+
+                return;
+            }
+
+            for (std::size_t i = 0; i < n->edges.size(); ++i)
+            {
+                StackEdge edge = n->edges[i];
+                bool is_via = n == via_from && edge.to == via->to && edge.tree == via->tree;
+
+                trees.push_back(edge.tree);
+                self(self, edge.to, rest - 1, passed || is_via);
+                trees.pop_back();
+            }
+        };
+
+        walk(walk, node, length, via == nullptr);
+
+        return paths;
+    }
+
+    GLRLevel::GLRLevel(const ParseTable &table, Forest &forest, std::deque<StackNode> &nodes, std::size_t entry, std::size_t position, Symbol *input, std::vector<StackNode *> tops)
+        : m_table { table },
+          m_forest { forest },
+          m_nodes { nodes },
+          m_entry { entry },
+          m_position { position },
+          m_input { input },
+          m_tops { std::move(tops) },
+          m_root { nullptr }
+    {
+    }
+
+    StackNode *GLRLevel::find_top(std::size_t state) const
+    {
+        auto iter = std::ranges::find_if(
+            m_tops,
+            [&](StackNode *node) {
+                return node->state == state;
+            });
+
+        return iter == m_tops.end() ? nullptr : *iter;
+    }
+
+    ForestNode *GLRLevel::tree(Symbol *symbol, std::size_t begin)
+    {
+        auto [ iter, inserted ] = m_trees.try_emplace(std::pair { symbol, begin }, nullptr);
+
+        if (inserted)
+        {
+            iter->second = m_forest.create_node(symbol, begin, m_position);
+        }
+
+        return iter->second;
+    }
+
+    void GLRLevel::run()
+    {
+        for (std::size_t i = 0; i < m_tops.size(); ++i)
+        {
+            act(m_tops[i]);
+        }
+
+        // Edges may still be added below a top after it has acted, so
+        // acceptance is decided once the level is complete.
+        auto is_accept = [](const Action &action) {
+            return action.type == ActionType::accept;
+        };
+
+        for (StackNode *top : m_tops)
+        {
+            if (std::ranges::none_of(m_table.actions(top->state, m_input), is_accept))
+            {
+                continue;
+            }
+
+            for (const StackEdge &edge : top->edges)
+            {
+                if (edge.to->level == 0 && edge.to->state == m_entry)
+                {
+                    m_root = edge.tree;
+                }
+            }
+        }
+    }
+
+    void GLRLevel::act(StackNode *node)
+    {
+        node->processed = true;
+
+        for (const Action &action : m_table.actions(node->state, m_input))
+        {
+            switch (action.type)
+            {
+            case ActionType::shift:
+                m_shifts.emplace_back(node, action.state);
+                break;
+            case ActionType::reduce:
+                for (const StackPath &path : paths_from(node, action.production->rhs.size()))
+                {
+                    reduce(path, action.production);
+                }
+                break;
+            case ActionType::accept:
+            case ActionType::go:
+                break;
+            }
+        }
+    }
+
+    void GLRLevel::reduce(const StackPath &path, const Production *p)
+    {
+        auto state = m_table.go(path.bottom->state, p->lhs);
+
+        if (!state.has_value())
+        {
+            return;
+        }
+
+        auto node = tree(p->lhs, path.bottom->level);
+
+        auto is_same_family = [&](const ForestFamily &family) {
+            return family.production == p && family.children == path.trees;
+        };
+
+        if (std::ranges::none_of(node->families, is_same_family))
+        {
+            node->families.push_back(ForestFamily { p, path.trees });
+        }
+
+        auto top = find_top(state.value());
+
+        if (top == nullptr)
+        {
+            top = &m_nodes.emplace_back(StackNode { state.value(), m_position, false, { } });
+            top->edges.push_back(StackEdge { path.bottom, node });
+            m_tops.push_back(top);
+            return;
+        }
+
+        auto is_same_edge = [&](const StackEdge &edge) {
+            return edge.to == path.bottom && edge.tree == node;
+        };
+
+        if (std::ranges::none_of(top->edges, is_same_edge))
+        {
+            add_edge(top, path.bottom, node);
+        }
+    }
+
+    // A new edge below a top that has already acted opens new reduction
+    // paths for every top that reaches it; only those are reduced again.
+    void GLRLevel::add_edge(StackNode *top, StackNode *bottom, ForestNode *node)
+    {
+        top->edges.push_back(StackEdge { bottom, node });
+
+        if (!top->processed)
+        {
+            return;
+        }
+
+        StackEdge edge { bottom, node };
+
+        for (std::size_t i = 0; i < m_tops.size(); ++i)
+        {
+            StackNode *from = m_tops[i];
+
+            if (!from->processed)
+            {
+                continue;
+            }
+
+            for (const Action &action : m_table.actions(from->state, m_input))
+            {
+                if (action.type != ActionType::reduce || action.production->rhs.empty())
+                {
+                    continue;
+                }
+
+                for (const StackPath &path : paths_from(from, action.production->rhs.size(), top, &edge))
+                {
+                    reduce(path, action.production);
+                }
+            }
+        }
+    }
+
+    ForestNode *GLRLevel::root() const
+    {
+        return m_root;
+    }
+
+    std::vector<StackNode *> GLRLevel::shift()
+    {
+        std::vector<StackNode *> tops;
+
+        if (m_shifts.empty())
+        {
+            return tops;
+        }
+
+        auto leaf = m_forest.create_node(m_input, m_position, m_position + 1);
+
+        for (auto [ from, state ] : m_shifts)
+        {
+            auto iter = std::ranges::find_if(
+                tops,
+                [&](StackNode *node) {
+                    return node->state == state;
+                });
+
+            StackNode *top;
+
+            if (iter == tops.end())
+            {
+                top = &m_nodes.emplace_back(StackNode { state, m_position + 1, false, { } });
+                tops.push_back(top);
+            }
+            else
+            {
+                top = *iter;
+            }
+
+            top->edges.push_back(StackEdge { from, leaf });
+        }
+
+        return tops;
+    }
+
+    // Tomita's algorithm with Farshi's correction for reductions that
+    // reach a top after it has acted. While the stack has a single top
+    // and the cells hold single actions, every level does what an LR
+    // parser would, on one node.
+    GLRResult glr_parse(const ParseTable &table, const std::vector<Symbol *> &input, std::size_t entry)
+    {
+        GLRResult result { false, 0, Forest { }, nullptr };
+        std::deque<StackNode> nodes;
+
+        std::vector<StackNode *> tops { &nodes.emplace_back(StackNode { entry, 0, false, { } }) };
+
+        for (std::size_t i = 0; i < input.size(); ++i)
+        {
+            GLRLevel level { table, result.forest, nodes, entry, i, input[i], std::move(tops) };
+
+            level.run();
+
+            if (level.root() != nullptr)
+            {
+                result.accepted = true;
+                result.position = i;
+                result.root = level.root();
+                return result;
+            }
+
+            tops = level.shift();
+
+            if (tops.empty())
+            {
+                result.position = i;
+                return result;
+            }
+        }
+
+        result.position = input.size();
+        return result;
+    }
+
+    static std::size_t saturating_add(std::size_t a, std::size_t b)
+    {
+        return a > std::numeric_limits<std::size_t>::max() - b ? std::numeric_limits<std::size_t>::max() : a + b;
+    }
+
+    static std::size_t saturating_multiply(std::size_t a, std::size_t b)
+    {
+        return a != 0 && b > std::numeric_limits<std::size_t>::max() / a ? std::numeric_limits<std::size_t>::max() : a * b;
+    }
+
+    // Derivations that run through a cycle of the forest are infinitely
+    // many; they are not counted.
+    std::size_t count_derivations(const ForestNode *root)
+    {
+        std::unordered_map<const ForestNode *, std::size_t> counts;
+
+        auto count = [&](auto &self, const ForestNode *node) -> std::size_t {
+            if (node->families.empty())
+            {
+                return 1;
+            }
+
+            auto [ iter, inserted ] = counts.try_emplace(node, 0);
+
+            if (!inserted)
+            {
+                return iter->second;
+            }
+
+            std::size_t total = 0;
+
+            for (const ForestFamily &family : node->families)
+            {
+                std::size_t product = 1;
+
+                for (const ForestNode *child : family.children)
+                {
+                    product = saturating_multiply(product, self(self, child));
+                }
+
+                total = saturating_add(total, product);
+            }
+
+            counts[node] = total;
+
+            return total;
+        };
+
+        return count(count, root);
+    }
+
+}
@@ -0,0 +1,76 @@
+#ifndef LR1CC_INCLUDE_GLR_HH
+#define LR1CC_INCLUDE_GLR_HH
+
+#include "table.hh"
+
+#include <deque>
+#include <vector>
+
+namespace lr1cc
+{
+
+    struct ForestNode;
+
+    struct ForestFamily
+    {
+        const Production *production;
+        std::vector<ForestNode *> children;
+    };
+
+    // A node of the shared packed parse forest: every derivation of
+    // `symbol' spanning the input from `begin' to `end', one family per
+    // derivation step. Terminal nodes have no families.
+    struct ForestNode
+    {
+        Symbol *symbol;
+        std::size_t begin;
+        std::size_t end;
+        std::vector<ForestFamily> families;
+    };
+
+    class Forest
+    {
+
+        std::deque<ForestNode> m_nodes;
+
+    public:
+
+        Forest() = default;
+
+        Forest(const Forest &) = delete;
+        Forest(Forest &&) = default;
+
+        Forest &operator=(const Forest &) = delete;
+        Forest &operator=(Forest &&) = default;
+
+        ForestNode *create_node(Symbol *, std::size_t, std::size_t);
+
+        std::size_t size() const;
+
+    };
+
+    struct GLRResult
+    {
+        bool accepted;
+        std::size_t position;
+        Forest forest;
+        ForestNode *root;
+    };
+
+    GLRResult glr_parse(const ParseTable &, const std::vector<Symbol *> &, std::size_t = 0);
+
+    std::size_t count_derivations(const ForestNode *);
+
+    inline ForestNode *Forest::create_node(Symbol *symbol, std::size_t begin, std::size_t end)
+    {
+        return &m_nodes.emplace_back(ForestNode { symbol, begin, end, { } });
+    }
+
+    inline std::size_t Forest::size() const
+    {
+        return m_nodes.size();
+    }
+
+}
+
+#endif
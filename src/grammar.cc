@@ -1,35 +1,36 @@
 
 #include "grammar.hh"
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 #include <utility>
 
 namespace lr1cc
 {
 
     Grammar::Grammar()
-        : m_start { nullptr },
-          m_end { nullptr }
+        : m_end { nullptr }
     {
     }
 
     Grammar::Grammar(Grammar &&g)
-        : m_start { g.m_start },
+        : m_starts { std::move(g.m_starts) },
           m_end { g.m_end },
           m_productions { std::move(g.m_productions) }
     {
-        g.m_start = nullptr;
+        g.m_starts.clear();
         g.m_end = nullptr;
     }
 
     Grammar &Grammar::operator=(Grammar &&g)
     {
-        m_start = g.m_start;
+        m_starts = std::move(g.m_starts);
         m_end = g.m_end;
         m_productions = std::move(g.m_productions);
 
-        g.m_start = nullptr;
+        g.m_starts.clear();
         g.m_end = nullptr;
 
         return *this;
@@ -37,8 +38,111 @@ namespace lr1cc
     
     void Grammar::calculate() const
     {
-        calculate_nullable();
-        calculate_first();
+        calculate_nullable(m_productions);
+        calculate_first(m_productions);
+    }
+
+    void Grammar::recalculate(const std::set<Symbol *, SymbolLess> &symbols) const
+    {
+        ProductionCatalog productions;
+
+        for (Symbol *s : symbols)
+        {
+            if (s->is_intermediate())
+            {
+                s->clear_nullable();
+                s->first().clear();
+            }
+        }
+
+        for (Production *p : m_productions)
+        {
+            if (symbols.contains(p->lhs))
+            {
+                productions.push_back(p);
+            }
+        }
+
+        calculate_nullable(productions);
+        calculate_first(productions);
+    }
+
+    SuffixFirstCatalog::SuffixFirstCatalog()
+    {
+    }
+
+    SuffixFirstCatalog::SuffixFirstCatalog(const Grammar &g)
+    {
+        for (Production *p : g.productions())
+        {
+            auto offset = m_suffixes.size();
+
+            m_offsets.emplace(p, offset);
+            m_suffixes.resize(offset + p->rhs.size() + 1);
+
+            m_suffixes[offset + p->rhs.size()].nullable = true;
+
+            for (std::size_t i = p->rhs.size(); i-- > 0; )
+            {
+                auto &suffix = m_suffixes[offset + i];
+                Symbol *s = p->rhs[i];
+
+                if (s->is_nullable())
+                {
+                    suffix = m_suffixes[offset + i + 1];
+                }
+                else
+                {
+                    suffix.nullable = false;
+                }
+
+                suffix.first.insert(s->first().cbegin(), s->first().cend());
+            }
+        }
+    }
+
+    FollowCatalog follow_sets(const Grammar &g, const SuffixFirstCatalog &suffixes)
+    {
+        FollowCatalog follows;
+
+        for (Symbol *start : g.starts())
+        {
+            follows[start].emplace(g.end());
+        }
+
+        bool updated = true;
+
+        while (updated)
+        {
+            updated = false;
+
+            for (Production *p : g.productions())
+            {
+                for (std::size_t i = 0; i < p->rhs.size(); ++i)
+                {
+                    if (!p->rhs[i]->is_intermediate())
+                    {
+                        continue;
+                    }
+
+                    auto &follow = follows[p->rhs[i]];
+                    auto &lhs_follow = follows[p->lhs];
+                    auto &suffix = suffixes.at(p, i + 1);
+                    auto prev_size = follow.size();
+
+                    follow.insert(suffix.first.cbegin(), suffix.first.cend());
+
+                    if (suffix.nullable && &follow != &lhs_follow)
+                    {
+                        follow.insert(lhs_follow.cbegin(), lhs_follow.cend());
+                    }
+
+                    updated = updated || prev_size != follow.size();
+                }
+            }
+        }
+
+        return follows;
     }
 
     static bool lhs_nullable_should_updated(Production *p)
@@ -47,7 +151,7 @@ namespace lr1cc
             && is_nullable(p->rhs);
     }
     
-    void Grammar::calculate_nullable() const
+    void Grammar::calculate_nullable(const ProductionCatalog &productions)
     {
         bool updated = true;
 
@@ -56,7 +160,7 @@ namespace lr1cc
             updated = false;
 
             std::ranges::for_each(
-                m_productions | std::ranges::views::filter(lhs_nullable_should_updated),
+                productions | std::ranges::views::filter(lhs_nullable_should_updated),
                 [&](Production *p) {
                     updated = true;
                     p->lhs->set_nullable();
@@ -64,7 +168,7 @@ namespace lr1cc
         }
     }
 
-    void Grammar::calculate_first() const
+    void Grammar::calculate_first(const ProductionCatalog &productions)
     {
         bool updated = true;
 
@@ -72,7 +176,7 @@ namespace lr1cc
         {
             updated = false;
 
-            for (Production *p : m_productions)
+            for (Production *p : productions)
             {
                 auto prev_size = p->lhs->first().size();
 
@@ -86,6 +190,17 @@ namespace lr1cc
     
     void Grammar::ensure_production_sanity(Production *p) const
     {
+        if (p->name.empty() && (p->rhs.size() != 1 || !p->rhs.front()->is_intermediate()))
+        {
+            std::ostringstream msg;
+
+            msg << "error: unnamed production of `"
+                << p->lhs->name()
+                << "' is not a unit production.\n";
+
+            throw std::runtime_error { msg.str() };
+        }
+
         if (!p->lhs->is_intermediate())
         {
             std::ostringstream msg;
@@ -118,7 +233,7 @@ namespace lr1cc
     
     void Grammar::ensure_sanity() const
     {
-        if (m_start == nullptr)
+        if (m_starts.empty())
         {
             throw std::runtime_error { "error: start symbol is not provided.\n" };
         }
@@ -133,5 +248,150 @@ namespace lr1cc
             ensure_production_sanity(p);
         }
     }
-    
+
+    static std::set<Symbol *, SymbolLess> productive_symbols(const ProductionCatalog &productions)
+    {
+        std::set<Symbol *, SymbolLess> productive;
+
+        auto is_productive = [&](Symbol *s) {
+            return s->is_terminal() || productive.contains(s);
+        };
+
+        bool updated = true;
+
+        while (updated)
+        {
+            updated = false;
+
+            for (Production *p : productions)
+            {
+                if (!productive.contains(p->lhs) && std::ranges::all_of(p->rhs, is_productive))
+                {
+                    productive.emplace(p->lhs);
+                    updated = true;
+                }
+            }
+        }
+
+        return productive;
+    }
+
+    static std::set<Symbol *, SymbolLess> reachable_symbols(const std::vector<Symbol *> &starts, const ProductionCatalog &productions)
+    {
+        std::unordered_map<Symbol *, std::vector<Production *>> lhs_to_productions;
+
+        for (Production *p : productions)
+        {
+            lhs_to_productions[p->lhs].push_back(p);
+        }
+
+        std::set<Symbol *, SymbolLess> reachable { starts.begin(), starts.end() };
+        std::vector<Symbol *> stack { starts };
+
+        while (!stack.empty())
+        {
+            auto s = stack.back();
+            stack.pop_back();
+
+            for (Production *p : lhs_to_productions[s])
+            {
+                for (Symbol *t : p->rhs)
+                {
+                    if (reachable.emplace(t).second)
+                    {
+                        stack.push_back(t);
+                    }
+                }
+            }
+        }
+
+        return reachable;
+    }
+
+    // Removes the symbols that derive no terminal string, then the
+    // symbols that no start symbol reaches, together with every
+    // production mentioning them. A removed production may have added
+    // to FIRST sets, so they are recalculated afterwards.
+    GrammarReduction Grammar::reduce(const SymbolManager &manager)
+    {
+        GrammarReduction reduction;
+
+        auto productive = productive_symbols(m_productions);
+
+        for (Symbol *start : m_starts)
+        {
+            if (!productive.contains(start))
+            {
+                std::ostringstream msg;
+                msg << "error: start symbol `" << start->name() << "' derives no terminal string.\n";
+                throw std::runtime_error { msg.str() };
+            }
+        }
+
+        auto is_unproductive = [&](Symbol *s) {
+            return s->is_intermediate() && !productive.contains(s);
+        };
+
+        ProductionCatalog productions;
+
+        for (Production *p : m_productions)
+        {
+            if (is_unproductive(p->lhs) || std::ranges::any_of(p->rhs, is_unproductive))
+            {
+                reduction.removed.push_back(p);
+            }
+            else
+            {
+                productions.push_back(p);
+            }
+        }
+
+        auto reachable = reachable_symbols(m_starts, productions);
+
+        for (Symbol *s : manager.symbols())
+        {
+            if (s->is_useless() || s == m_end)
+            {
+                continue;
+            }
+
+            if (is_unproductive(s))
+            {
+                reduction.unproductive.push_back(s);
+                s->set_useless();
+            }
+            else if (!reachable.contains(s))
+            {
+                reduction.unreachable.push_back(s);
+                s->set_useless();
+            }
+        }
+
+        std::erase_if(productions, [&](Production *p) {
+            if (p->lhs->is_useless())
+            {
+                reduction.removed.push_back(p);
+                return true;
+            }
+
+            return false;
+        });
+
+        m_productions = std::move(productions);
+
+        if (!reduction.removed.empty())
+        {
+            std::set<Symbol *, SymbolLess> live;
+
+            for (Production *p : m_productions)
+            {
+                live.emplace(p->lhs);
+            }
+
+            recalculate(live);
+        }
+
+        return reduction;
+    }
+
 }
@@ -3,6 +3,8 @@
 
 #include "symbol.hh"
 
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace lr1cc
@@ -16,16 +18,23 @@ namespace lr1cc
     };
 
     using ProductionCatalog = std::vector<Production *>;
+
+    struct GrammarReduction
+    {
+        std::vector<Symbol *> unproductive;
+        std::vector<Symbol *> unreachable;
+        ProductionCatalog removed;
+    };
     
     class Grammar
     {
 
-        Symbol *m_start;
+        std::vector<Symbol *> m_starts;
         Symbol *m_end;
         ProductionCatalog m_productions;
 
-        void calculate_nullable() const;
-        void calculate_first() const;
+        static void calculate_nullable(const ProductionCatalog &);
+        static void calculate_first(const ProductionCatalog &);
 
         void ensure_production_sanity(Production *) const;
         
@@ -42,6 +51,9 @@ namespace lr1cc
         Symbol *start() const;
         void set_start(Symbol *);
 
+        const std::vector<Symbol *> &starts() const;
+        void add_start(Symbol *);
+
         Symbol *end() const;
         void set_end(Symbol *);
 
@@ -49,19 +61,60 @@ namespace lr1cc
         ProductionCatalog &productions();
 
         void calculate() const;
+        void recalculate(const std::set<Symbol *, SymbolLess> &) const;
 
         void ensure_sanity() const;
+
+        GrammarReduction reduce(const SymbolManager &);
         
     };
 
+    struct SuffixFirst
+    {
+        First first;
+        bool nullable;
+    };
+
+    // FIRST and nullability of p->rhs[position..] for every production
+    // p and every 0 <= position <= p->rhs.size(), computed once from the
+    // FIRST sets of the symbols.
+    class SuffixFirstCatalog
+    {
+
+        std::unordered_map<const Production *, std::size_t> m_offsets;
+        std::vector<SuffixFirst> m_suffixes;
+
+    public:
+
+        SuffixFirstCatalog();
+        explicit SuffixFirstCatalog(const Grammar &);
+
+        const SuffixFirst &at(const Production *, std::size_t) const;
+
+    };
+
+    using FollowCatalog = std::unordered_map<Symbol *, First>;
+
+    FollowCatalog follow_sets(const Grammar &, const SuffixFirstCatalog &);
+
     inline Symbol *Grammar::start() const
     {
-        return m_start;
+        return m_starts.empty() ? nullptr : m_starts.front();
     }
 
     inline void Grammar::set_start(Symbol *s)
     {
-        m_start = s;
+        m_starts = { s };
+    }
+
+    inline const std::vector<Symbol *> &Grammar::starts() const
+    {
+        return m_starts;
+    }
+
+    inline void Grammar::add_start(Symbol *s)
+    {
+        m_starts.push_back(s);
     }
 
     inline Symbol *Grammar::end() const
@@ -83,6 +136,11 @@ namespace lr1cc
     {
         return m_productions;
     }
+
+    inline const SuffixFirst &SuffixFirstCatalog::at(const Production *p, std::size_t position) const
+    {
+        return m_suffixes[m_offsets.at(p) + position];
+    }
     
 }
 
@@ -0,0 +1,427 @@
+
+#include "incremental.hh"
+#include "layout.hh"
+#include "output.hh"
+
+#include <algorithm>
+#include <deque>
+#include <ranges>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace lr1cc
+{
+
+    static std::unordered_map<std::size_t, std::string> row_contents(const std::vector<DFAState *> &rows, const std::vector<std::size_t> &ids, const std::vector<Symbol *> &columns)
+    {
+        std::unordered_map<DFAState *, std::size_t> state_to_id;
+
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            state_to_id.emplace(rows[i], ids[i]);
+        }
+
+        std::unordered_map<std::size_t, std::string> contents;
+
+        for (DFAState *state : rows)
+        {
+            std::ostringstream row;
+
+            output_lr1_table_row(state, columns, state_to_id, row);
+
+            contents.emplace(state_to_id.at(state), row.str());
+        }
+
+        return contents;
+    }
+
+    Automaton::Automaton(Grammar &g, const std::vector<Symbol *> &columns)
+        : m_grammar { g },
+          m_nfa { grammar_to_nfa(g, m_construction) },
+          m_next_row_id { 1 }
+    {
+        build_dfa(std::unordered_set<NFAState *> { });
+
+        auto rows = bfs_layout(m_dfa, columns).rows;
+
+        m_rows = row_contents(rows, identify_rows(rows), columns);
+    }
+
+    // A row is keyed by its kernel items: the NFA states other than the
+    // named ones, each with the lookahead of the named state it was
+    // grown from. Keys do not depend on the position of the row, so a
+    // row keeps its id when states are inserted before it.
+    std::vector<std::size_t> Automaton::identify_rows(const std::vector<DFAState *> &rows)
+    {
+        std::unordered_set<NFAState *> named_states;
+        std::unordered_map<NFAState *, Symbol *> lookaheads;
+
+        for (const auto &[ key, named_state ] : m_construction.named_states)
+        {
+            named_states.emplace(named_state);
+
+            std::vector<NFAState *> stack { named_state };
+
+            while (!stack.empty())
+            {
+                auto state = stack.back();
+                stack.pop_back();
+
+                for (const auto &[ input, to_states ] : state->transitions())
+                {
+                    if (input == nullptr)
+                    {
+                        continue;
+                    }
+
+                    for (NFAState *to_state : to_states)
+                    {
+                        if (lookaheads.emplace(to_state, key.second).second)
+                        {
+                            stack.push_back(to_state);
+                        }
+                    }
+                }
+            }
+        }
+
+        std::unordered_map<DFAState *, const std::set<NFAState *> *> dfa_to_nfa;
+
+        for (const auto &pair : m_nfa_to_dfa)
+        {
+            dfa_to_nfa.emplace(pair.second, &pair.first);
+        }
+
+        std::vector<std::vector<std::pair<std::size_t, std::size_t>>> kernels;
+
+        for (DFAState *row : rows)
+        {
+            auto &kernel = kernels.emplace_back();
+
+            for (NFAState *state : *dfa_to_nfa.at(row))
+            {
+                if (named_states.contains(state))
+                {
+                    continue;
+                }
+
+                auto lookahead = lookaheads.find(state);
+
+                kernel.emplace_back(state->core(), lookahead == lookaheads.end() ? 0 : lookahead->second->id() + 1);
+            }
+
+            std::ranges::sort(kernel);
+        }
+
+        auto cores_of = [](const std::vector<std::pair<std::size_t, std::size_t>> &kernel) {
+            std::vector<std::size_t> cores;
+
+            for (const auto &item : kernel)
+            {
+                if (cores.empty() || cores.back() != item.first)
+                {
+                    cores.push_back(item.first);
+                }
+            }
+
+            return cores;
+        };
+
+        std::vector<std::size_t> ids(rows.size(), 0);
+        std::set<std::size_t> matched;
+
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            auto old = m_row_ids.find(kernels[i]);
+
+            if (old != m_row_ids.end())
+            {
+                ids[i] = old->second;
+                matched.emplace(old->second);
+            }
+        }
+
+        // A row whose lookaheads changed, such as after FIRST grew, is
+        // matched to an unmatched old row with the same LR(0) items.
+        std::map<std::vector<std::size_t>, std::deque<std::size_t>> unmatched;
+
+        for (const auto &[ kernel, id ] : m_row_ids)
+        {
+            if (!matched.contains(id))
+            {
+                unmatched[cores_of(kernel)].push_back(id);
+            }
+        }
+
+        for (auto &queue : unmatched | std::views::values)
+        {
+            std::ranges::sort(queue);
+        }
+
+        decltype(m_row_ids) row_ids;
+
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            if (ids[i] == 0)
+            {
+                auto candidates = unmatched.find(cores_of(kernels[i]));
+
+                if (candidates != unmatched.end() && !candidates->second.empty())
+                {
+                    ids[i] = candidates->second.front();
+                    candidates->second.pop_front();
+                }
+                else
+                {
+                    ids[i] = m_next_row_id++;
+                }
+            }
+
+            row_ids.emplace(std::move(kernels[i]), ids[i]);
+        }
+
+        m_row_ids = std::move(row_ids);
+
+        return ids;
+    }
+
+    using DFAStateQueue = std::deque<std::pair<const std::set<NFAState *> *, DFAState *>>;
+
+    static DFAState *get_dfa_state(std::set<NFAState *> &&nstates, DFA &dfa, NFAStatesDFAStateAssociation &nfa_to_dfa, FinalStateCatalog &finals, DFAStateQueue &queue)
+    {
+        auto action = sole_action(nstates);
+
+        if (action.has_value() && finals.contains(action.value()))
+        {
+            return finals.at(action.value());
+        }
+
+        auto iter = nfa_to_dfa.find(nstates);
+
+        if (iter != nfa_to_dfa.end())
+        {
+            return iter->second;
+        }
+
+        auto dstate = dfa.create_state(nstates);
+        auto inserted = nfa_to_dfa.emplace(std::move(nstates), dstate).first;
+
+        queue.push_back(std::pair { &inserted->first, dstate });
+
+        if (action.has_value())
+        {
+            finals.emplace(action.value(), dstate);
+        }
+
+        return dstate;
+    }
+
+    static auto contains_any_fn(const std::unordered_set<NFAState *> &dirty)
+    {
+        return [&](const std::set<NFAState *> &nstates) {
+            return std::ranges::any_of(nstates, [&](NFAState *state) {
+                return dirty.contains(state);
+            });
+        };
+    }
+
+    // A transition of an old DFA state is reused when neither its
+    // source nor its target set contains a regrown named state: the
+    // move and the epsilon closure then only follow unchanged NFA
+    // transitions.
+    void Automaton::build_dfa(const std::unordered_set<NFAState *> &dirty)
+    {
+        auto old_nfa_to_dfa = std::move(m_nfa_to_dfa);
+        m_nfa_to_dfa = NFAStatesDFAStateAssociation { };
+
+        std::unordered_map<DFAState *, const std::set<NFAState *> *> old_dfa_to_nfa;
+
+        for (const auto &pair : old_nfa_to_dfa)
+        {
+            old_dfa_to_nfa.emplace(pair.second, &pair.first);
+        }
+
+        auto is_dirty = contains_any_fn(dirty);
+
+        DFA dfa;
+        FinalStateCatalog finals;
+        DFAStateQueue queue;
+
+        for (auto &initial_nstates : initial_state_sets(m_nfa))
+        {
+            dfa.add_start(get_dfa_state(std::move(initial_nstates), dfa, m_nfa_to_dfa, finals, queue));
+        }
+
+        while (!queue.empty())
+        {
+            auto [ nstates, dstate ] = queue.front();
+            queue.pop_front();
+
+            auto old = old_nfa_to_dfa.find(*nstates);
+
+            if (old != old_nfa_to_dfa.end() && !is_dirty(*nstates))
+            {
+                for (const auto &[ input, old_to_dstate ] : old->second->transitions())
+                {
+                    const auto &old_to_nstates = *old_dfa_to_nfa.at(old_to_dstate);
+
+                    auto to_nstates = is_dirty(old_to_nstates)
+                        ? transit(*nstates, input)
+                        : old_to_nstates;
+
+                    auto to_dstate = get_dfa_state(std::move(to_nstates), dfa, m_nfa_to_dfa, finals, queue);
+
+                    dstate->transitions().emplace(input, to_dstate);
+                }
+            }
+            else
+            {
+                for (Symbol *input : nfa_states_inputs(*nstates))
+                {
+                    auto to_dstate = get_dfa_state(transit(*nstates, input), dfa, m_nfa_to_dfa, finals, queue);
+
+                    dstate->transitions().emplace(input, to_dstate);
+                }
+            }
+        }
+
+        m_dfa = std::move(dfa);
+    }
+
+    static std::set<Symbol *, SymbolLess> affected_symbols(const std::set<Symbol *, SymbolLess> &changed, const ProductionCatalog &productions, const ProductionDiff &diff)
+    {
+        std::unordered_map<Symbol *, std::vector<Symbol *>> dependents;
+
+        auto add_dependents = [&](Production *p) {
+            for (Symbol *s : p->rhs)
+            {
+                dependents[s].push_back(p->lhs);
+            }
+        };
+
+        std::ranges::for_each(productions, add_dependents);
+        std::ranges::for_each(diff.removed, add_dependents);
+
+        std::set<Symbol *, SymbolLess> affected { changed };
+        std::deque<Symbol *> queue { changed.cbegin(), changed.cend() };
+
+        while (!queue.empty())
+        {
+            auto s = queue.front();
+            queue.pop_front();
+
+            auto iter = dependents.find(s);
+
+            if (iter == dependents.end())
+            {
+                continue;
+            }
+
+            for (Symbol *dependent : iter->second)
+            {
+                if (affected.emplace(dependent).second)
+                {
+                    queue.push_back(dependent);
+                }
+            }
+        }
+
+        return affected;
+    }
+
+    AutomatonUpdate Automaton::update(const ProductionDiff &diff, const std::vector<Symbol *> &columns)
+    {
+        std::set<Symbol *, SymbolLess> changed_lhs;
+
+        auto &productions = m_grammar.productions();
+
+        for (Production *p : diff.removed)
+        {
+            changed_lhs.emplace(p->lhs);
+            std::erase(productions, p);
+        }
+
+        for (Production *p : diff.added)
+        {
+            changed_lhs.emplace(p->lhs);
+            productions.push_back(p);
+        }
+
+        auto affected = affected_symbols(changed_lhs, productions, diff);
+
+        std::unordered_map<Symbol *, std::pair<bool, First>> previous;
+
+        for (Symbol *s : affected)
+        {
+            previous.emplace(s, std::pair { s->is_nullable(), s->first() });
+        }
+
+        m_grammar.recalculate(affected);
+
+        std::set<Symbol *, SymbolLess> changed_first;
+
+        for (Symbol *s : affected)
+        {
+            if (previous.at(s) != std::pair { s->is_nullable(), s->first() })
+            {
+                changed_first.emplace(s);
+            }
+        }
+
+        std::set<Symbol *, SymbolLess> regrown_lhs { changed_lhs };
+
+        for (Production *p : productions)
+        {
+            if (std::ranges::any_of(p->rhs, [&](Symbol *s) { return changed_first.contains(s); }))
+            {
+                regrown_lhs.emplace(p->lhs);
+            }
+        }
+
+        auto regrown = regrow_named_states(regrown_lhs, m_nfa, m_grammar, m_construction);
+
+        build_dfa(std::unordered_set<NFAState *> { regrown.cbegin(), regrown.cend() });
+
+        // The item states which the regrown named states had before are
+        // now unreachable. The named states themselves are kept, even
+        // when unused, because the catalog refers to them.
+        std::vector<NFAState *> named_states;
+
+        for (const auto &pair : m_construction.named_states)
+        {
+            named_states.push_back(pair.second);
+        }
+
+        m_nfa.remove_unreachable_states(named_states);
+
+        auto rows = bfs_layout(m_dfa, columns).rows;
+        auto ids = identify_rows(rows);
+        auto contents = row_contents(rows, ids, columns);
+
+        AutomatonUpdate result { { }, 0 };
+
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            auto old = m_rows.find(ids[i]);
+
+            if (old == m_rows.end() || old->second != contents.at(ids[i]))
+            {
+                result.changed_rows.push_back(i + 1);
+            }
+        }
+
+        for (const auto &pair : m_rows)
+        {
+            if (!contents.contains(pair.first))
+            {
+                ++result.removed_rows;
+            }
+        }
+
+        m_rows = std::move(contents);
+
+        return result;
+    }
+
+}
@@ -0,0 +1,87 @@
+#ifndef LR1CC_INCLUDE_INCREMENTAL_HH
+#define LR1CC_INCLUDE_INCREMENTAL_HH
+
+#include "grammar.hh"
+#include "nfa.hh"
+#include "dfa.hh"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace lr1cc
+{
+
+    struct ProductionDiff
+    {
+        std::vector<Production *> added;
+        std::vector<Production *> removed;
+    };
+
+    // Rows are numbered as in the table after the update. A row is
+    // changed when no row of the table before had its kernel items or
+    // when its actions differ; removed rows are those whose kernel
+    // items no longer occur.
+    struct AutomatonUpdate
+    {
+        std::vector<std::size_t> changed_rows;
+        std::size_t removed_rows;
+    };
+
+    // Automaton keeps the intermediate results of the construction so
+    // that an edit of the productions recomputes only the FIRST sets,
+    // named NFA states and DFA states which the edit can affect.
+    class Automaton
+    {
+
+        Grammar &m_grammar;
+        NFAConstruction m_construction;
+        NFA m_nfa;
+        DFA m_dfa;
+        NFAStatesDFAStateAssociation m_nfa_to_dfa;
+        std::map<std::vector<std::pair<std::size_t, std::size_t>>, std::size_t> m_row_ids;
+        std::size_t m_next_row_id;
+        std::unordered_map<std::size_t, std::string> m_rows;
+
+        void build_dfa(const std::unordered_set<NFAState *> &);
+        std::vector<std::size_t> identify_rows(const std::vector<DFAState *> &);
+
+    public:
+
+        Automaton(Grammar &, const std::vector<Symbol *> &);
+
+        Automaton(const Automaton &) = delete;
+        Automaton(Automaton &&) = delete;
+
+        Automaton &operator=(const Automaton &) = delete;
+        Automaton &operator=(Automaton &&) = delete;
+
+        const Grammar &grammar() const;
+        const NFA &nfa() const;
+        const DFA &dfa() const;
+
+        AutomatonUpdate update(const ProductionDiff &, const std::vector<Symbol *> &);
+
+    };
+
+    inline const Grammar &Automaton::grammar() const
+    {
+        return m_grammar;
+    }
+
+    inline const NFA &Automaton::nfa() const
+    {
+        return m_nfa;
+    }
+
+    inline const DFA &Automaton::dfa() const
+    {
+        return m_dfa;
+    }
+
+}
+
+#endif
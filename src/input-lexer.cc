@@ -1,127 +1,132 @@
 
 #include "input.hh"
 
-#include <cctype>
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 
 namespace lr1cc
 {
 
-    Lexer::Lexer(std::istream &in)
-        : m_in { in },
-          m_line { 1 }
-    {
-    }
-    
-    int Lexer::front_char()
+    enum CharClass : unsigned char
     {
-        if (m_front_char.has_value())
-        {
-            return m_front_char.value();
-        }
+        space_class = 1,
+        ident_class = 2
+    };
 
-        m_front_char = m_in.get();
-        
-        return m_front_char.value();
-    }
+    static constexpr auto char_classes = []() {
+        std::array<unsigned char, 256> classes {};
 
-    void Lexer::pop_char()
-    {
-        if (m_front_char == '\n')
+        for (unsigned char ch : std::string_view { " \t\n\v\f\r" })
         {
-            ++m_line;
+            classes[ch] = space_class;
         }
-        
-        m_front_char = std::nullopt;
-    }
 
-    void Lexer::skip_spaces()
-    {
-        while (true)
+        for (int ch = 0; ch < 256; ++ch)
         {
-            int ch = front_char();
-
-            if (ch == -1)
-            {
-                break;
-            }
-            else if (std::isspace(ch))
-            {
-                pop_char();
-            }
-            else if (ch == '#')
+            if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')
+                || ch == '_' || ch == '-' || ch == '.')
             {
-                pop_char();
-                skip_line();
-            }
-            else
-            {
-                break;
+                classes[ch] = ident_class;
             }
         }
+
+        return classes;
+    }();
+
+    static unsigned char char_class(char ch)
+    {
+        return char_classes[static_cast<unsigned char>(ch)];
     }
 
-    void Lexer::skip_line()
+    // Skips eight bytes per iteration while the whole block belongs to
+    // the class, and finishes the last block byte by byte.
+    static const char *scan_class(const char *p, const char *limit, unsigned char cls)
     {
-        while (true)
+        while (limit - p >= 8)
         {
-            int ch = front_char();
+            auto block = char_class(p[0]) & char_class(p[1]) & char_class(p[2]) & char_class(p[3])
+                & char_class(p[4]) & char_class(p[5]) & char_class(p[6]) & char_class(p[7]);
 
-            if (ch == -1)
+            if ((block & cls) == 0)
             {
                 break;
             }
-            else if (ch == '\n')
-            {
-                pop_char();
-                break;
-            }
-            else
-            {
-                pop_char();
-            }
+
+            p += 8;
+        }
+
+        while (p != limit && (char_class(*p) & cls) != 0)
+        {
+            ++p;
         }
+
+        return p;
     }
 
-    static bool is_ident_char(int ch)
+    Lexer::Lexer(std::string_view in)
+        : m_cursor { in.data() },
+          m_limit { in.data() + in.size() },
+          m_line { 1 }
     {
-        return std::isalnum(ch)
-            || ch == '_'
-            || ch == '-'
-            || ch == '.';
     }
 
-    std::string Lexer::read_ident_string()
+    Lexer::Lexer(std::istream &in)
+        : m_storage { std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> { } },
+          m_cursor { m_storage.data() },
+          m_limit { m_storage.data() + m_storage.size() },
+          m_line { 1 }
     {
-        std::string str;
+    }
 
-        while (true)
+    void Lexer::skip_spaces()
+    {
+        while (m_cursor != m_limit)
         {
-            int ch = front_char();
-
-            if (ch == -1)
+            if (char_class(*m_cursor) == space_class)
             {
-                break;
+                auto end = scan_class(m_cursor, m_limit, space_class);
+
+                m_line += std::count(m_cursor, end, '\n');
+                m_cursor = end;
             }
-            else if (is_ident_char(ch))
+            else if (*m_cursor == '#')
             {
-                pop_char();
-                str.push_back(ch);
+                auto newline = static_cast<const char *>(std::memchr(m_cursor, '\n', m_limit - m_cursor));
+
+                if (newline == nullptr)
+                {
+                    m_cursor = m_limit;
+                }
+                else
+                {
+                    ++m_line;
+                    m_cursor = newline + 1;
+                }
             }
             else
             {
                 break;
             }
         }
+    }
+
+    std::string_view Lexer::read_ident_string()
+    {
+        auto begin = m_cursor;
+
+        m_cursor = scan_class(m_cursor, m_limit, ident_class);
 
-        return str;
+        return std::string_view { begin, static_cast<std::size_t>(m_cursor - begin) };
     }
 
     void Lexer::load_section_marker()
     {
-        std::string name = read_ident_string();
+        auto name = read_ident_string();
 
         if (name == "start")
         {
@@ -143,6 +148,10 @@ namespace lr1cc
         {
             m_front = Token { TokenType::grammar_marker, "%grammar" };
         }
+        else if (name == "include")
+        {
+            m_front = Token { TokenType::include_marker, "%include" };
+        }
         else
         {
             std::ostringstream msg;
@@ -157,11 +166,28 @@ namespace lr1cc
 
     void Lexer::load_ident()
     {
-        std::string value = read_ident_string();
-        m_front = Token { TokenType::ident, value };
+        m_front = Token { TokenType::ident, read_ident_string() };
     }
     
-    Token Lexer::front()
+    void Lexer::load_string()
+    {
+        auto begin = m_cursor;
+        auto end = std::find_if(begin, m_limit, [](char ch) {
+            return ch == '"' || ch == '\n';
+        });
+
+        if (end == m_limit || *end != '"')
+        {
+            std::ostringstream msg;
+            msg << "lexical error: unterminated string at line " << line() << ".\n";
+            throw std::runtime_error { msg.str() };
+        }
+
+        m_cursor = end + 1;
+        m_front = Token { TokenType::string, std::string_view { begin, static_cast<std::size_t>(end - begin) } };
+    }
+
+    const Token &Lexer::front()
     {
         if (m_front.has_value())
         {
@@ -170,43 +196,50 @@ namespace lr1cc
 
         skip_spaces();
 
-        int ch1 = front_char();
-
-        if (ch1 == -1)
+        if (m_cursor == m_limit)
         {
             m_front = Token { TokenType::end, "EOF" };
+            return m_front.value();
         }
-        else if (ch1 == '%')
+
+        char ch1 = *m_cursor;
+
+        if (ch1 == '%')
         {
-            pop_char();
+            ++m_cursor;
             load_section_marker();
         }
         else if (ch1 == ':')
         {
-            pop_char();
+            ++m_cursor;
             m_front = Token { TokenType::colon, ":" };
         }
         else if (ch1 == '|')
         {
-            pop_char();
+            ++m_cursor;
             m_front = Token { TokenType::bar, "|" };
         }
         else if (ch1 == ';')
         {
-            pop_char();
+            ++m_cursor;
             m_front = Token { TokenType::semicolon, ";" };
         }
         else if (ch1 == '[')
         {
-            pop_char();
+            ++m_cursor;
             m_front = Token { TokenType::square_start, "[" };
         }
         else if (ch1 == ']')
         {
-            pop_char();
+            ++m_cursor;
             m_front = Token { TokenType::square_end, "]" };
         }
-        else if (is_ident_char(ch1))
+        else if (ch1 == '"')
+        {
+            ++m_cursor;
+            load_string();
+        }
+        else if (char_class(ch1) == ident_class)
         {
             load_ident();
         }
@@ -214,10 +247,10 @@ namespace lr1cc
         {
             std::ostringstream msg;
             msg << "lexical error: unexpected character `"
-                << static_cast<char>(ch1)
+                << ch1
                 << "' (0x"
                 << std::setw(2) << std::setfill('0') << std::hex
-                << ch1
+                << static_cast<int>(static_cast<unsigned char>(ch1))
                 << ") at line "
                 << std::setfill(' ') << std::dec
                 << line()
@@ -1,6 +1,10 @@
 
 #include "input.hh"
+#include "module.hh"
 
+#include <filesystem>
+#include <iterator>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string_view>
@@ -8,14 +12,13 @@
 namespace lr1cc
 {
 
-    static void parse_input_language(Lexer &, Grammar &, SymbolManager &, std::vector<std::unique_ptr<Production>> &);
-    static void parse_start_section(Lexer &, Grammar &, SymbolManager &);
-    static void parse_end_section(Lexer &, Grammar &, SymbolManager &);
-    static void parse_terminal_section(Lexer &, Grammar &, SymbolManager &);
-    static void parse_intermediate_section(Lexer &, Grammar &, SymbolManager &);
-    static void parse_grammar_section(Lexer &, Grammar &, SymbolManager &, std::vector<std::unique_ptr<Production>> &);
-    static void parse_production(Lexer &, Grammar &, SymbolManager &, std::vector<std::unique_ptr<Production>> &);
-    static void parse_rhs_1(Lexer &, Symbol *, Grammar &, SymbolManager &, std::vector<std::unique_ptr<Production>> &);
+    static void parse_start_section(Lexer &, std::vector<ModuleItem> &);
+    static void parse_end_section(Lexer &, std::vector<ModuleItem> &);
+    static void parse_symbol_section(Lexer &, ModuleItemType, std::vector<ModuleItem> &);
+    static void parse_include_section(Lexer &, std::vector<ModuleItem> &);
+    static void parse_grammar_section(Lexer &, std::vector<ModuleItem> &);
+    static void parse_production(Lexer &, std::vector<ModuleItem> &);
+    static void parse_rhs_1(Lexer &, ModuleSymbol, std::vector<ModuleItem> &);
 
     [[noreturn]] static void unexpected_token(const Token &token, Lexer &lexer, std::string_view expected)
     {
@@ -43,19 +46,12 @@ namespace lr1cc
 
         lexer.pop();
     }
-    
-    Grammar parse_input(std::istream &in, SymbolManager &manager, std::vector<std::unique_ptr<Production>> &productions)
+
+    std::vector<ModuleItem> parse_module(std::string_view in)
     {
-        Grammar g;
+        std::vector<ModuleItem> items;
         Lexer lexer { in };
 
-        parse_input_language(lexer, g, manager, productions);
-
-        return g;
-    }
-
-    static void parse_input_language(Lexer &lexer, Grammar &g, SymbolManager &manager, std::vector<std::unique_ptr<Production>> &productions)
-    {
         while (true)
         {
             auto tok = lexer.front();
@@ -63,27 +59,32 @@ namespace lr1cc
             if (tok.type == TokenType::start_marker)
             {
                 lexer.pop();
-                parse_start_section(lexer, g, manager);
+                parse_start_section(lexer, items);
             }
             else if (tok.type == TokenType::end_marker)
             {
                 lexer.pop();
-                parse_end_section(lexer, g, manager);
+                parse_end_section(lexer, items);
             }
             else if (tok.type == TokenType::terminal_marker)
             {
                 lexer.pop();
-                parse_terminal_section(lexer, g, manager);
+                parse_symbol_section(lexer, ModuleItemType::terminal, items);
             }
             else if (tok.type == TokenType::intermediate_marker)
             {
                 lexer.pop();
-                parse_intermediate_section(lexer, g, manager);
+                parse_symbol_section(lexer, ModuleItemType::intermediate, items);
             }
             else if (tok.type == TokenType::grammar_marker)
             {
                 lexer.pop();
-                parse_grammar_section(lexer, g, manager, productions);
+                parse_grammar_section(lexer, items);
+            }
+            else if (tok.type == TokenType::include_marker)
+            {
+                lexer.pop();
+                parse_include_section(lexer, items);
             }
             else if (tok.type == TokenType::end)
             {
@@ -94,18 +95,12 @@ namespace lr1cc
                 unexpected_token(tok, lexer, "section marker or EOF");
             }
         }
-        
+
+        return items;
     }
 
-    static void parse_start_section(Lexer &lexer, Grammar &g, SymbolManager &manager)
+    static ModuleSymbol expect_ident(Lexer &lexer)
     {
-        if (g.start() != nullptr)
-        {
-            std::ostringstream msg;
-            msg << "error: start symbol redeclared at line " << lexer.line() << ".\n";
-            throw std::runtime_error { msg.str() };
-        }
-        
         auto tok = lexer.front();
 
         if (tok.type != TokenType::ident)
@@ -113,206 +108,280 @@ namespace lr1cc
             unexpected_token(tok, lexer, "an identifier");
         }
 
-        auto s = manager.create_symbol(tok.value, SymbolType::intermediate);
+        ModuleSymbol symbol { tok.value, lexer.line() };
+        lexer.pop();
 
-        if (s == nullptr)
+        return symbol;
+    }
+
+    static void parse_start_section(Lexer &lexer, std::vector<ModuleItem> &items)
+    {
+        items.push_back(ModuleItem { ModuleItemType::start, expect_ident(lexer), { }, { } });
+
+        while (lexer.front().type == TokenType::ident)
         {
-            std::ostringstream msg;
-            msg << "error: symbol `" << tok.value << "' redeclared at line " << lexer.line() << ".\n";
-            throw std::runtime_error { msg.str() };
+            items.push_back(ModuleItem { ModuleItemType::start, expect_ident(lexer), { }, { } });
         }
+    }
 
-        g.set_start(s);
-        lexer.pop();
+    static void parse_end_section(Lexer &lexer, std::vector<ModuleItem> &items)
+    {
+        items.push_back(ModuleItem { ModuleItemType::end, expect_ident(lexer), { }, { } });
     }
-    
-    static void parse_end_section(Lexer &lexer, Grammar &g, SymbolManager &manager)
+
+    static void parse_symbol_section(Lexer &lexer, ModuleItemType type, std::vector<ModuleItem> &items)
     {
-        if (g.end() != nullptr)
+        while (lexer.front().type == TokenType::ident)
         {
-            std::ostringstream msg;
-            msg << "error: End-Of-Tokens symbol redeclared at line " << lexer.line() << ".\n";
-            throw std::runtime_error { msg.str() };
+            items.push_back(ModuleItem { type, expect_ident(lexer), { }, { } });
         }
-        
+    }
+
+    static void parse_include_section(Lexer &lexer, std::vector<ModuleItem> &items)
+    {
         auto tok = lexer.front();
 
-        if (tok.type != TokenType::ident)
+        if (tok.type != TokenType::string)
         {
-            std::ostringstream msg;
-            msg << "syntax error: unexpected token `"
-                << tok.value
-                << "' at line "
-                << lexer.line()
-                << ", expecting an identifier.\n";
-
-            throw std::runtime_error { msg.str() };
+            unexpected_token(tok, lexer, "a string");
         }
 
-        auto s = manager.create_symbol(tok.value, SymbolType::terminal);
+        items.push_back(ModuleItem { ModuleItemType::include, ModuleSymbol { tok.value, lexer.line() }, { }, { } });
+        lexer.pop();
+    }
 
-        if (s == nullptr)
+    static void parse_grammar_section(Lexer &lexer, std::vector<ModuleItem> &items)
+    {
+        while (lexer.front().type == TokenType::ident)
         {
-            std::ostringstream msg;
-            msg << "error: symbol `" << tok.value << "' redeclared at line " << lexer.line() << ".\n";
-            throw std::runtime_error { msg.str() };
+            parse_production(lexer, items);
         }
-
-        g.set_end(s);
-        lexer.pop();
     }
-    
-    static void parse_terminal_section(Lexer &lexer, Grammar &g, SymbolManager &manager)
+
+    static void parse_production(Lexer &lexer, std::vector<ModuleItem> &items)
     {
+        auto lhs = expect_ident(lexer);
+
+        consume_token(lexer, TokenType::colon, "`:'");
+
+        parse_rhs_1(lexer, lhs, items);
+
         while (true)
         {
             auto tok = lexer.front();
 
-            if (tok.type != TokenType::ident)
+            if (tok.type == TokenType::bar)
             {
+                lexer.pop();
+                parse_rhs_1(lexer, lhs, items);
+            }
+            else if (tok.type == TokenType::semicolon)
+            {
+                lexer.pop();
                 break;
             }
-
-            auto s = manager.create_symbol(tok.value, SymbolType::terminal);
-
-            if (s == nullptr)
+            else
             {
-                std::ostringstream msg;
-                msg << "error: symbol `" << tok.value << "' redeclared at line " << lexer.line() << ".\n";
-                throw std::runtime_error { msg.str() };
+                unexpected_token(tok, lexer, "`|' or `;'");
             }
-
-            lexer.pop();
         }
     }
-    
-    static void parse_intermediate_section(Lexer &lexer, Grammar &g, SymbolManager &manager)
+
+    static void parse_rhs_1(Lexer &lexer, ModuleSymbol lhs, std::vector<ModuleItem> &items)
     {
+        std::vector<ModuleSymbol> rhs;
+
         while (true)
         {
             auto tok = lexer.front();
 
-            if (tok.type != TokenType::ident)
+            if (tok.type == TokenType::ident)
+            {
+                rhs.push_back(ModuleSymbol { tok.value, lexer.line() });
+                lexer.pop();
+            }
+            else if (tok.type == TokenType::square_start)
             {
+                lexer.pop();
                 break;
             }
-
-            auto s = manager.create_symbol(tok.value, SymbolType::intermediate);
-
-            if (s == nullptr)
+            else
             {
-                std::ostringstream msg;
-                msg << "error: symbol `" << tok.value << "' redeclared at line " << lexer.line() << ".\n";
-                throw std::runtime_error { msg.str() };
+                unexpected_token(tok, lexer, "an identifier or `['");
             }
+        }
+
+        std::string_view name;
 
-            lexer.pop();
+        if (lexer.front().type != TokenType::square_end)
+        {
+            name = expect_ident(lexer).name;
         }
+
+        consume_token(lexer, TokenType::square_end, "`]'");
+
+        items.push_back(ModuleItem { ModuleItemType::production, lhs, name, std::move(rhs) });
     }
-    
-    static void parse_grammar_section(Lexer &lexer, Grammar &g, SymbolManager &manager, std::vector<std::unique_ptr<Production>> &productions)
+
+    struct MergeContext
     {
-        while (true)
+        Grammar &g;
+        SymbolManager &manager;
+        std::vector<std::unique_ptr<Production>> &productions;
+        ModuleCache &cache;
+        std::vector<ModuleSource> &sources;
+        std::set<std::filesystem::path> included;
+    };
+
+    [[noreturn]] static void merge_error(std::string_view what, std::size_t line)
+    {
+        std::ostringstream msg;
+        msg << "error: " << what << " at line " << line << ".\n";
+        throw std::runtime_error { msg.str() };
+    }
+
+    static Symbol *declare_symbol(const ModuleSymbol &symbol, SymbolType type, MergeContext &ctx)
+    {
+        auto s = ctx.manager.create_symbol(symbol.name, type);
+
+        if (s == nullptr)
         {
-            auto tok = lexer.front();
+            merge_error("symbol `" + std::string { symbol.name } + "' redeclared", symbol.line);
+        }
 
-            if (tok.type != TokenType::ident)
-            {
-                break;
-            }
+        return s;
+    }
 
-            parse_production(lexer, g, manager, productions);
+    static Symbol *resolve_symbol(const ModuleSymbol &symbol, MergeContext &ctx)
+    {
+        auto s = ctx.manager.get_symbol(symbol.name);
+
+        if (s == nullptr)
+        {
+            merge_error("unknown symbol `" + std::string { symbol.name } + "'", symbol.line);
         }
+
+        return s;
     }
 
-    static void parse_production(Lexer &lexer, Grammar &g, SymbolManager &manager, std::vector<std::unique_ptr<Production>> &productions)
+    static void merge_module(const std::vector<ModuleItem> &, const std::filesystem::path &, MergeContext &);
+
+    // A module is merged at most once per grammar, so fragments shared
+    // by several includes do not redeclare their symbols.
+    static void merge_include(const ModuleSymbol &include, const std::filesystem::path &base, MergeContext &ctx)
     {
-        auto lhs_tok = lexer.front();
+        auto path = base.parent_path() / include.name;
 
-        auto lhs = manager.get_symbol(lhs_tok.value);
+        std::error_code ec;
+        auto canonical = std::filesystem::weakly_canonical(path, ec);
 
-        if (lhs == nullptr)
+        if (!ctx.included.insert(ec ? path : canonical).second)
         {
-            std::ostringstream msg;
-            msg << "error: unknown symbol `" << lhs_tok.value << "' at line " << lexer.line() << ".\n";
-            throw std::runtime_error { msg.str() };
+            return;
         }
 
-        lexer.pop();
-        consume_token(lexer, TokenType::colon, "`:'");
-
-        parse_rhs_1(lexer, lhs, g, manager, productions);
+        std::shared_ptr<const GrammarModule> module;
 
-        while (true)
+        try
         {
-            auto tok = lexer.front();
+            module = ctx.cache.load(path.string());
 
-            if (tok.type == TokenType::bar)
-            {
-                lexer.pop();
-                parse_rhs_1(lexer, lhs, g, manager, productions);
-            }
-            else if (tok.type == TokenType::semicolon)
+            if (module != nullptr)
             {
-                lexer.pop();
-                break;
-            }
-            else
-            {
-                unexpected_token(tok, lexer, "`|' or `;'");
+                ctx.sources.push_back(ModuleSource { path.string(), module });
+                merge_module(module->items, path, ctx);
             }
         }
+        catch (std::runtime_error &e)
+        {
+            std::ostringstream msg;
+            msg << e.what() << "note: in `" << path.string() << "' included at line " << include.line << ".\n";
+            throw std::runtime_error { msg.str() };
+        }
+
+        if (module == nullptr)
+        {
+            merge_error("failed to include `" + path.string() + "'", include.line);
+        }
     }
-    
-    static void parse_rhs_1(Lexer &lexer, Symbol *lhs, Grammar &g, SymbolManager &manager, std::vector<std::unique_ptr<Production>> &productions)
-    {
-        std::vector<Symbol *> rhs;
 
-        while (true)
+    static void merge_module(const std::vector<ModuleItem> &items, const std::filesystem::path &path, MergeContext &ctx)
+    {
+        for (const ModuleItem &item : items)
         {
-            auto tok = lexer.front();
+            switch (item.type)
+            {
+            case ModuleItemType::start:
+                ctx.g.add_start(declare_symbol(item.symbol, SymbolType::intermediate, ctx));
+                break;
+            case ModuleItemType::end:
+                if (ctx.g.end() != nullptr)
+                {
+                    merge_error("End-Of-Tokens symbol redeclared", item.symbol.line);
+                }
 
-            if (tok.type == TokenType::ident)
+                ctx.g.set_end(declare_symbol(item.symbol, SymbolType::terminal, ctx));
+                break;
+            case ModuleItemType::terminal:
+                declare_symbol(item.symbol, SymbolType::terminal, ctx);
+                break;
+            case ModuleItemType::intermediate:
+                declare_symbol(item.symbol, SymbolType::intermediate, ctx);
+                break;
+            case ModuleItemType::production:
             {
-                auto s = manager.get_symbol(tok.value);
+                auto lhs = resolve_symbol(item.symbol, ctx);
+                std::vector<Symbol *> rhs;
 
-                if (s == nullptr)
+                for (const ModuleSymbol &symbol : item.rhs)
                 {
-                    std::ostringstream msg;
-                    msg << "error: unknown symbol `" << tok.value << "' at line " << lexer.line() << ".\n";
-                    throw std::runtime_error { msg.str() };
+                    rhs.push_back(resolve_symbol(symbol, ctx));
                 }
 
-                rhs.push_back(s);
+                auto p = std::make_unique<Production>(std::string { item.name }, lhs, std::move(rhs));
 
-                lexer.pop();
-            }
-            else if (tok.type == TokenType::square_start)
-            {
-                lexer.pop();
+                ctx.g.productions().push_back(p.get());
+                ctx.productions.push_back(std::move(p));
                 break;
             }
-            else
-            {
-                unexpected_token(tok, lexer, "an identifier or `['");
+            case ModuleItemType::include:
+                merge_include(item.symbol, path, ctx);
+                break;
             }
         }
+    }
 
-        auto name = lexer.front();
+    Grammar parse_input(std::string_view in, const std::string &path, ModuleCache &cache, std::vector<ModuleSource> &sources, SymbolManager &manager, std::vector<std::unique_ptr<Production>> &productions)
+    {
+        Grammar g;
+        MergeContext ctx { g, manager, productions, cache, sources, { } };
 
-        if (name.type != TokenType::ident)
+        if (!path.empty())
         {
-            unexpected_token(name, lexer, "an identifier");
+            std::error_code ec;
+            auto canonical = std::filesystem::weakly_canonical(path, ec);
+
+            ctx.included.insert(ec ? std::filesystem::path { path } : canonical);
         }
 
-        lexer.pop();
-        consume_token(lexer, TokenType::square_end, "`]'");
-                
-        auto p = std::make_unique<Production>(name.value, lhs, rhs);
+        merge_module(parse_module(in), path, ctx);
 
-        g.productions().push_back(p.get());
+        return g;
+    }
+
+    Grammar parse_input(std::string_view in, SymbolManager &manager, std::vector<std::unique_ptr<Production>> &productions)
+    {
+        ModuleCache cache;
+        std::vector<ModuleSource> sources;
+
+        return parse_input(in, "", cache, sources, manager, productions);
+    }
 
-        productions.push_back(std::move(p));
+    Grammar parse_input(std::istream &in, SymbolManager &manager, std::vector<std::unique_ptr<Production>> &productions)
+    {
+        std::string content { std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> { } };
+
+        return parse_input(content, manager, productions);
     }
-    
+
 }
@@ -7,6 +7,7 @@
 #include <optional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace lr1cc
@@ -20,6 +21,8 @@ namespace lr1cc
         terminal_marker,
         intermediate_marker,
         grammar_marker,
+        include_marker,
+        string,
         colon,
         bar,
         semicolon,
@@ -31,31 +34,32 @@ namespace lr1cc
     struct Token
     {
         TokenType type;
-        std::string value;
+        std::string_view value;
     };
-    
+
+    // Lexer scans a whole buffer and returns tokens as views into it; a
+    // Lexer constructed from a stream owns a copy of the stream content.
     class Lexer
     {
 
-        std::istream &m_in;
-        std::optional<int> m_front_char;
+        std::string m_storage;
+        const char *m_cursor;
+        const char *m_limit;
         std::size_t m_line;
         std::optional<Token> m_front;
-        
-        int front_char();
-        void pop_char();
 
-        void skip_line();
         void skip_spaces();
 
-        std::string read_ident_string();
+        std::string_view read_ident_string();
         
         void load_section_marker();
         void load_ident();
+        void load_string();
         
     public:
 
-        Lexer(std::istream &);
+        explicit Lexer(std::string_view);
+        explicit Lexer(std::istream &);
 
         Lexer(const Lexer &) = delete;
         Lexer(Lexer &&) = delete;
@@ -65,11 +69,55 @@ namespace lr1cc
 
         std::size_t line() const;
 
-        Token front();
+        const Token &front();
         void pop();
         
     };
 
+    enum class ModuleItemType
+    {
+        start,
+        end,
+        terminal,
+        intermediate,
+        production,
+        include
+    };
+
+    struct ModuleSymbol
+    {
+        std::string_view name;
+        std::size_t line;
+    };
+
+    // A ModuleItem names symbols by views into the module text; symbols
+    // are resolved only when the module is merged into a grammar.
+    struct ModuleItem
+    {
+        ModuleItemType type;
+        ModuleSymbol symbol;
+        std::string_view name;
+        std::vector<ModuleSymbol> rhs;
+    };
+
+    struct GrammarModule
+    {
+        std::string content;
+        std::vector<ModuleItem> items;
+    };
+
+    struct ModuleSource
+    {
+        std::string path;
+        std::shared_ptr<const GrammarModule> module;
+    };
+
+    class ModuleCache;
+
+    std::vector<ModuleItem> parse_module(std::string_view);
+
+    Grammar parse_input(std::string_view, const std::string &, ModuleCache &, std::vector<ModuleSource> &, SymbolManager &, std::vector<std::unique_ptr<Production>> &);
+    Grammar parse_input(std::string_view, SymbolManager &, std::vector<std::unique_ptr<Production>> &);
     Grammar parse_input(std::istream &, SymbolManager &, std::vector<std::unique_ptr<Production>> &);
     
     inline std::size_t Lexer::line() const
@@ -0,0 +1,242 @@
+#include "layout.hh"
+
+#include <algorithm>
+#include <charconv>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace lr1cc
+{
+
+    std::string entry_path_prefix(std::size_t entry)
+    {
+        return entry == 0 ? std::string { } : "%" + std::to_string(entry + 1);
+    }
+
+    std::unordered_map<DFAState *, std::string> state_access_paths(const DFA &dfa)
+    {
+        std::unordered_map<DFAState *, std::string> paths;
+
+        for_each_dfa_state_with_path(
+            dfa.starts(),
+            [&](DFAState *state, const std::vector<Symbol *> &path, std::size_t entry) {
+                if (!is_row_state(state))
+                {
+                    return;
+                }
+
+                auto key = entry_path_prefix(entry);
+
+                for (Symbol *s : path)
+                {
+                    if (!key.empty())
+                    {
+                        key.push_back(' ');
+                    }
+
+                    key.append(s->name());
+                }
+
+                paths.emplace(state, std::move(key));
+            });
+
+        return paths;
+    }
+
+    TableLayout bfs_layout(const DFA &dfa, const std::vector<Symbol *> &columns)
+    {
+        TableLayout layout { { }, columns, dfa.starts().size() };
+
+        for_each_dfa_state(
+            dfa.starts(),
+            [&](DFAState *state) {
+                if (is_row_state(state))
+                {
+                    layout.rows.push_back(state);
+                }
+            });
+
+        return layout;
+    }
+
+    template <typename Key>
+    static void sort_columns(std::vector<Symbol *> &columns, Key key)
+    {
+        auto terminals_end = std::stable_partition(
+            columns.begin(), columns.end(),
+            [](Symbol *s) {
+                return s->is_terminal();
+            });
+
+        auto by_key = [&](Symbol *a, Symbol *b) {
+            return key(a) > key(b);
+        };
+
+        std::stable_sort(columns.begin(), terminals_end, by_key);
+        std::stable_sort(terminals_end, columns.end(), by_key);
+    }
+
+    // A state is placed right after the state that first reaches it, so
+    // a run of shifts walks forward through the table. Columns are
+    // ordered by the number of rows that have an action in them.
+    TableLayout dfs_layout(const DFA &dfa, const std::vector<Symbol *> &columns)
+    {
+        TableLayout layout { dfa.starts(), columns, dfa.starts().size() };
+        std::unordered_set<DFAState *> visited { dfa.starts().begin(), dfa.starts().end() };
+        std::unordered_map<Symbol *, std::size_t> filled;
+
+        for (DFAState *start : dfa.starts())
+        {
+            std::vector<DFAState *> stack { start };
+
+            while (!stack.empty())
+            {
+                auto state = stack.back();
+                stack.pop_back();
+
+                if (state != start)
+                {
+                    layout.rows.push_back(state);
+                }
+
+                for (auto iter = state->transitions().rbegin(); iter != state->transitions().rend(); ++iter)
+                {
+                    ++filled[iter->first];
+
+                    if (is_row_state(iter->second) && !visited.contains(iter->second))
+                    {
+                        visited.emplace(iter->second);
+                        stack.push_back(iter->second);
+                    }
+                }
+            }
+        }
+
+        sort_columns(
+            layout.columns,
+            [&](Symbol *s) {
+                auto iter = filled.find(s);
+                return iter == filled.end() ? 0 : iter->second;
+            });
+
+        return layout;
+    }
+
+    // Rows are sorted by hits, hottest first after the entry states, and
+    // fall back to the DFS order for states the profile did not reach.
+    TableLayout profile_layout(const DFA &dfa, const std::vector<Symbol *> &columns, const Profile &profile)
+    {
+        auto layout = dfs_layout(dfa, columns);
+        auto paths = state_access_paths(dfa);
+
+        auto state_hits = [&](DFAState *state) -> std::uint64_t {
+            auto iter = profile.states.find(paths.at(state));
+            return iter == profile.states.end() ? 0 : iter->second;
+        };
+
+        std::stable_sort(
+            layout.rows.begin() + static_cast<std::ptrdiff_t>(layout.entries), layout.rows.end(),
+            [&](DFAState *a, DFAState *b) {
+                return state_hits(a) > state_hits(b);
+            });
+
+        layout.columns = columns;
+
+        sort_columns(
+            layout.columns,
+            [&](Symbol *s) -> std::uint64_t {
+                auto iter = profile.symbols.find(s->name());
+                return iter == profile.symbols.end() ? 0 : iter->second;
+            });
+
+        return layout;
+    }
+
+    // Every line is `state COUNT SYMBOL...' or `symbol COUNT NAME'; the
+    // counts of repeated lines add up, so profiles can be concatenated.
+    Profile read_profile(std::istream &in)
+    {
+        Profile profile;
+        std::string line;
+        std::size_t line_number = 0;
+
+        while (std::getline(in, line))
+        {
+            ++line_number;
+
+            std::istringstream fields { line };
+            std::string kind, count_field;
+
+            if (!(fields >> kind) || kind.starts_with('#'))
+            {
+                continue;
+            }
+
+            std::uint64_t count;
+
+            auto invalid = [&]() {
+                return std::runtime_error { "error: invalid profile at line " + std::to_string(line_number) + ".\n" };
+            };
+
+            if (!(fields >> count_field))
+            {
+                throw invalid();
+            }
+
+            auto [ ptr, ec ] = std::from_chars(count_field.data(), count_field.data() + count_field.size(), count);
+
+            if (ec != std::errc {} || ptr != count_field.data() + count_field.size())
+            {
+                throw invalid();
+            }
+
+            std::string key, name;
+
+            while (fields >> name)
+            {
+                if (!key.empty())
+                {
+                    key.push_back(' ');
+                }
+
+                key.append(name);
+            }
+
+            if (kind == "state")
+            {
+                profile.states[key] += count;
+            }
+            else if (kind == "symbol" && !key.empty() && key.find(' ') == std::string::npos)
+            {
+                profile.symbols[key] += count;
+            }
+            else
+            {
+                throw invalid();
+            }
+        }
+
+        return profile;
+    }
+
+    void write_profile(const Profile &profile, std::ostream &out)
+    {
+        std::map<std::string, std::uint64_t> states { profile.states.begin(), profile.states.end() };
+        std::map<std::string, std::uint64_t> symbols { profile.symbols.begin(), profile.symbols.end() };
+
+        for (const auto &[ path, count ] : states)
+        {
+            out << "state " << count << (path.empty() ? "" : " ") << path << '\n';
+        }
+
+        for (const auto &[ name, count ] : symbols)
+        {
+            out << "symbol " << count << ' ' << name << '\n';
+        }
+
+        out << std::flush;
+    }
+
+}
@@ -0,0 +1,57 @@
+#ifndef LR1CC_INCLUDE_LAYOUT_HH
+#define LR1CC_INCLUDE_LAYOUT_HH
+
+#include "dfa.hh"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lr1cc
+{
+
+    // The order of the rows and columns of a parsing table. The entry
+    // states of the start symbols are always the first `entries' rows,
+    // in the order of the start symbols, and terminals always precede
+    // intermediate symbols.
+    struct TableLayout
+    {
+        std::vector<DFAState *> rows;
+        std::vector<Symbol *> columns;
+        std::size_t entries = 1;
+    };
+
+    // Hit counts recorded by a runtime. A state is identified by the
+    // symbols on the first path that reaches it in breadth-first search
+    // by symbol order, so a profile stays valid whatever layout the
+    // profiled table had. A path from the entry state of a start symbol
+    // other than the first begins with `%N', N being its row name.
+    struct Profile
+    {
+        std::unordered_map<std::string, std::uint64_t> states;
+        std::unordered_map<std::string, std::uint64_t> symbols;
+    };
+
+    bool is_row_state(const DFAState *);
+
+    std::string entry_path_prefix(std::size_t);
+
+    std::unordered_map<DFAState *, std::string> state_access_paths(const DFA &);
+
+    TableLayout bfs_layout(const DFA &, const std::vector<Symbol *> &);
+    TableLayout dfs_layout(const DFA &, const std::vector<Symbol *> &);
+    TableLayout profile_layout(const DFA &, const std::vector<Symbol *> &, const Profile &);
+
+    Profile read_profile(std::istream &);
+    void write_profile(const Profile &, std::ostream &);
+
+    inline bool is_row_state(const DFAState *state)
+    {
+        return state->rejects() || !state->transitions().empty();
+    }
+
+}
+
+#endif
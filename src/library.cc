@@ -0,0 +1,203 @@
+
+#include "library.hh"
+#include "input.hh"
+#include "module.hh"
+#include "output.hh"
+
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace lr1cc
+{
+
+    static Config build_config(const BuildOptions &options)
+    {
+        Config conf { { }, false };
+
+        conf.stats = StatsFormat::text;
+        conf.limits = options.limits;
+        conf.construction = options.construction;
+        conf.fallback_lalr = options.fallback_lalr;
+        conf.elide_unit = options.elide_unit;
+        conf.glr = options.glr;
+        conf.layout = options.layout;
+
+        return conf;
+    }
+
+    static std::vector<std::string> symbol_names(const std::vector<Symbol *> &symbols)
+    {
+        std::vector<std::string> names;
+
+        for (Symbol *s : symbols)
+        {
+            names.push_back(s->name());
+        }
+
+        return names;
+    }
+
+    static ConflictInfo conflict_info(const Conflict &conflict, const Grammar &g)
+    {
+        std::ostringstream report;
+        report_conflict(conflict, g, report);
+
+        return ConflictInfo {
+            conflict.first_state == conflict.second_state,
+            g.starts()[conflict.entry]->name(),
+            symbol_names(conflict.start_to_first),
+            symbol_names(conflict.first_to_second),
+            report.str()
+        };
+    }
+
+    static void fill_table(TableResult &result, const Grammar &g, const TableLayout &layout)
+    {
+        std::unordered_map<Symbol *, std::uint32_t> symbol_index;
+        std::unordered_map<const Production *, std::uint32_t> production_index;
+
+        for (Symbol *s : layout.columns)
+        {
+            symbol_index.emplace(s, static_cast<std::uint32_t>(result.symbols.size()));
+            result.symbols.push_back(SymbolInfo { s->name(), s->is_terminal() });
+        }
+
+        result.terminals = std::ranges::count_if(layout.columns, [](Symbol *s) { return s->is_terminal(); });
+
+        for (Production *p : g.productions())
+        {
+            ProductionInfo info { p->name, symbol_index.at(p->lhs), { } };
+
+            for (Symbol *s : p->rhs)
+            {
+                info.rhs.push_back(symbol_index.at(s));
+            }
+
+            production_index.emplace(p, static_cast<std::uint32_t>(result.productions.size()));
+            result.productions.push_back(std::move(info));
+        }
+
+        for (Symbol *start : g.starts())
+        {
+            result.starts.push_back(symbol_index.at(start));
+        }
+
+        result.table.emplace(layout);
+
+        const auto &table = result.table.value();
+        auto nonterminals = result.symbols.size() - result.terminals;
+
+        result.rows = table.rows();
+        result.actions.assign(result.rows * result.terminals, ActionCell { CellType::error, 0 });
+        result.gotos.assign(result.rows * nonterminals, no_goto);
+
+        for (std::size_t row = 0; row < result.rows; ++row)
+        {
+            for (std::size_t column = 0; column < result.terminals; ++column)
+            {
+                auto actions = table.actions(row, column);
+
+                if (actions.empty())
+                {
+                    continue;
+                }
+
+                auto &cell = result.actions[row * result.terminals + column];
+                const Action &action = actions.front();
+
+                switch (action.type)
+                {
+                case ActionType::shift:
+                    cell = ActionCell { CellType::shift, static_cast<std::uint32_t>(action.state) };
+                    break;
+                case ActionType::reduce:
+                    cell = ActionCell { CellType::reduce, production_index.at(action.production) };
+                    break;
+                case ActionType::accept:
+                    cell = ActionCell { CellType::accept, 0 };
+                    break;
+                case ActionType::go:
+                    break;
+                }
+            }
+
+            for (std::size_t column = 0; column < nonterminals; ++column)
+            {
+                auto to_row = table.go(row, result.terminals + column);
+
+                if (to_row.has_value())
+                {
+                    result.gotos[row * nonterminals + column] = static_cast<std::uint32_t>(to_row.value());
+                }
+            }
+        }
+    }
+
+    static void build(TableResult &result, std::string_view text, const BuildOptions &options, std::ostream &diagnostics)
+    {
+        auto conf = build_config(options);
+        Stopwatch stopwatch;
+        ModuleCache modules;
+        std::vector<ModuleSource> sources;
+
+        result.stats.input = options.input_name;
+
+        auto g = parse_input(text, options.input_name, modules, sources, *result.manager, result.grammar_productions);
+        result.stats.phases.push_back(stopwatch.lap("parse"));
+
+        g.calculate();
+        g.ensure_sanity();
+        result.stats.phases.push_back(stopwatch.lap("first"));
+
+        report_reduction(g.reduce(*result.manager), diagnostics);
+        result.stats.phases.push_back(stopwatch.lap("reduce"));
+
+        auto [ dfa, conflicts ] = build_automaton(conf, g, *result.manager, result.stats, stopwatch, diagnostics);
+
+        for (const Conflict &conflict : conflicts)
+        {
+            result.conflicts.push_back(conflict_info(conflict, g));
+        }
+
+        if (!conflicts.empty() && !conf.glr)
+        {
+            diagnostics << conflicts.size() << (conflicts.size() == 1 ? " conflict" : " conflicts") << " detected.\n";
+            report_conflicts(conflicts, g, diagnostics);
+
+            result.status = BuildStatus::conflict;
+            return;
+        }
+
+        auto columns = table_columns(*result.manager);
+        auto layout = build_layout(conf, dfa, columns, &options.profile, result.stats, stopwatch);
+
+        fill_table(result, g, layout);
+
+        result.stats.table = parse_table_stats(result.table.value());
+        result.stats.phases.push_back(stopwatch.lap("output"));
+        result.status = BuildStatus::success;
+    }
+
+    TableResult build_table(std::string_view text, const BuildOptions &options)
+    {
+        TableResult result { BuildStatus::failure, { }, { }, { }, 0, { }, 0, { }, { }, { }, { }, std::make_unique<SymbolManager>(), { }, std::nullopt };
+        std::ostringstream diagnostics;
+
+        try
+        {
+            build(result, text, options, diagnostics);
+        }
+        catch (std::runtime_error &e)
+        {
+            diagnostics << e.what();
+            result.status = BuildStatus::failure;
+        }
+
+        result.diagnostics = diagnostics.str();
+        result.stats.peak_rss_kib = peak_rss_kib();
+
+        return result;
+    }
+
+}
@@ -0,0 +1,100 @@
+#ifndef LR1CC_INCLUDE_LIBRARY_HH
+#define LR1CC_INCLUDE_LIBRARY_HH
+
+#include "budget.hh"
+#include "cli.hh"
+#include "driver.hh"
+#include "layout.hh"
+#include "static-table.hh"
+#include "stats.hh"
+#include "symbol.hh"
+#include "table.hh"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lr1cc
+{
+
+    struct BuildOptions
+    {
+        Limits limits = {};
+        ConstructionType construction = ConstructionType::lr1;
+        bool fallback_lalr = false;
+        bool elide_unit = false;
+        bool glr = false;
+        LayoutType layout = LayoutType::bfs;
+        Profile profile = {};
+        std::string input_name = "<input>";
+    };
+
+    struct SymbolInfo
+    {
+        std::string name;
+        bool terminal;
+    };
+
+    // Symbols are indices into TableResult::symbols.
+    struct ProductionInfo
+    {
+        std::string name;
+        std::uint32_t lhs;
+        std::vector<std::uint32_t> rhs;
+    };
+
+    struct ConflictInfo
+    {
+        bool reduce_reduce;
+        std::string start;
+        std::vector<std::string> prefix;
+        std::vector<std::string> continuation;
+        std::string report;
+    };
+
+    // The result of build_table. Symbols are in column order, terminals
+    // first; `actions' has a row of `terminals' cells and `gotos' a row
+    // of the remaining columns for every table row. Row i is the entry
+    // state of the start symbol starts[i]. A cell with several actions,
+    // kept with `glr', holds its first one; `table' holds all of them.
+    struct TableResult
+    {
+        BuildStatus status;
+        std::string diagnostics;
+        Stats stats;
+        std::vector<SymbolInfo> symbols;
+        std::size_t terminals;
+        std::vector<ProductionInfo> productions;
+        std::size_t rows;
+        std::vector<std::uint32_t> starts;
+        std::vector<ActionCell> actions;
+        std::vector<std::uint32_t> gotos;
+        std::vector<ConflictInfo> conflicts;
+        std::unique_ptr<SymbolManager> manager;
+        std::vector<std::unique_ptr<Production>> grammar_productions;
+        std::optional<ParseTable> table;
+
+        const ActionCell &action(std::size_t, std::size_t) const;
+        std::uint32_t go(std::size_t, std::size_t) const;
+    };
+
+    // Builds the table of a grammar given as text, without touching
+    // the file system except for %include.
+    TableResult build_table(std::string_view, const BuildOptions & = {});
+
+    inline const ActionCell &TableResult::action(std::size_t row, std::size_t terminal) const
+    {
+        return actions[row * terminals + terminal];
+    }
+
+    inline std::uint32_t TableResult::go(std::size_t row, std::size_t nonterminal) const
+    {
+        return gotos[row * (symbols.size() - terminals) + nonterminal];
+    }
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+
+#include "mapped-file.hh"
+
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lr1cc
+{
+
+    MappedFile::MappedFile(const std::string &path)
+        : m_data { nullptr },
+          m_size { 0 }
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0)
+        {
+            throw std::runtime_error { "error: failed to open `" + path + "'.\n" };
+        }
+
+        struct stat st;
+
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            ::close(fd);
+            throw std::runtime_error { "error: failed to open `" + path + "'.\n" };
+        }
+
+        m_size = static_cast<std::size_t>(st.st_size);
+
+        if (m_size != 0)
+        {
+            m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (m_data == MAP_FAILED)
+            {
+                m_data = nullptr;
+                ::close(fd);
+                throw std::runtime_error { "error: failed to map `" + path + "'.\n" };
+            }
+
+            ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+        }
+
+        ::close(fd);
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+        : m_data { std::exchange(other.m_data, nullptr) },
+          m_size { std::exchange(other.m_size, 0) }
+    {
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data != nullptr)
+        {
+            ::munmap(m_data, m_size);
+        }
+    }
+
+}
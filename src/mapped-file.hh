@@ -0,0 +1,41 @@
+#ifndef LR1CC_INCLUDE_MAPPED_FILE_HH
+#define LR1CC_INCLUDE_MAPPED_FILE_HH
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace lr1cc
+{
+
+    // MappedFile maps a whole file read-only into memory.
+    class MappedFile
+    {
+
+        void *m_data;
+        std::size_t m_size;
+
+    public:
+
+        explicit MappedFile(const std::string &);
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile(MappedFile &&) noexcept;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+        MappedFile &operator=(MappedFile &&) noexcept;
+
+        ~MappedFile();
+
+        std::string_view view() const;
+
+    };
+
+    inline std::string_view MappedFile::view() const
+    {
+        return std::string_view { static_cast<const char *>(m_data), m_size };
+    }
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+
+#include "module.hh"
+#include "mapped-file.hh"
+#include "util.hh"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+namespace lr1cc
+{
+
+    ModuleCache::ModuleCache()
+        : m_hits { 0 },
+          m_misses { 0 }
+    {
+    }
+
+    std::shared_ptr<const GrammarModule> ModuleCache::load(const std::string &path)
+    {
+        std::optional<MappedFile> file;
+
+        try
+        {
+            file.emplace(path);
+        }
+        catch (std::runtime_error &e)
+        {
+            return nullptr;
+        }
+
+        auto content = file->view();
+        auto hash = fnv1a_hash(content);
+
+        auto has_content = [&](const std::shared_ptr<const GrammarModule> &module) {
+            return module->content == content;
+        };
+
+        {
+            std::lock_guard lock { m_mutex };
+
+            auto &candidates = m_modules[hash];
+            auto iter = std::ranges::find_if(candidates, has_content);
+
+            if (iter != candidates.end())
+            {
+                ++m_hits;
+                return *iter;
+            }
+
+            ++m_misses;
+        }
+
+        auto module = std::make_shared<GrammarModule>();
+        module->content = content;
+        module->items = parse_module(module->content);
+
+        std::lock_guard lock { m_mutex };
+
+        auto &candidates = m_modules[hash];
+        auto iter = std::ranges::find_if(candidates, has_content);
+
+        if (iter != candidates.end())
+        {
+            return *iter;
+        }
+
+        candidates.push_back(module);
+
+        return module;
+    }
+
+}
@@ -0,0 +1,55 @@
+#ifndef LR1CC_INCLUDE_MODULE_HH
+#define LR1CC_INCLUDE_MODULE_HH
+
+#include "input.hh"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lr1cc
+{
+
+    // ModuleCache keeps parsed grammar modules keyed by the hash of
+    // their content, so a module shared by many grammars is lexed and
+    // parsed once. It may be shared between threads.
+    class ModuleCache
+    {
+
+        std::mutex m_mutex;
+        std::unordered_map<std::uint64_t, std::vector<std::shared_ptr<const GrammarModule>>> m_modules;
+        std::size_t m_hits;
+        std::size_t m_misses;
+
+    public:
+
+        ModuleCache();
+
+        ModuleCache(const ModuleCache &) = delete;
+        ModuleCache &operator=(const ModuleCache &) = delete;
+
+        std::shared_ptr<const GrammarModule> load(const std::string &);
+
+        std::size_t hits();
+        std::size_t misses();
+
+    };
+
+    inline std::size_t ModuleCache::hits()
+    {
+        std::lock_guard lock { m_mutex };
+        return m_hits;
+    }
+
+    inline std::size_t ModuleCache::misses()
+    {
+        std::lock_guard lock { m_mutex };
+        return m_misses;
+    }
+
+}
+
+#endif
@@ -7,12 +7,14 @@
 #include <ranges>
 #include <utility>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace lr1cc
 {
 
-    NFAState::NFAState(const Acceptance &acceptance)
-        : m_acceptance { acceptance }
+    NFAState::NFAState(const Acceptance &acceptance, std::size_t core)
+        : m_acceptance { acceptance },
+          m_core { core }
     {
     }
 
@@ -30,16 +32,18 @@ namespace lr1cc
         }
     }
 
-    static auto contained_in_fn(const std::set<NFAState *> &set)
+    template <typename Set>
+    static auto contained_in_fn(const Set &set)
     {
         return [&](NFAState *x) {
             return set.contains(x);
         };
     }
-    
-    void epsilon_close(std::set<NFAState *> &set)
+
+    template <typename Set>
+    static void close_states(Set &set, std::pmr::memory_resource *resource)
     {
-        std::deque<NFAState *> queue { set.cbegin(), set.cend() };
+        std::pmr::deque<NFAState *> queue { set.cbegin(), set.cend(), resource };
 
         while (!queue.empty())
         {
@@ -62,10 +66,19 @@ namespace lr1cc
         }
     }
 
-    std::set<NFAState *> transit(const std::set<NFAState *> &states, Symbol *input)
+    void epsilon_close(std::set<NFAState *> &set)
     {
-        std::set<NFAState *> to_states;
+        close_states(set, std::pmr::get_default_resource());
+    }
+
+    void epsilon_close(std::pmr::set<NFAState *> &set)
+    {
+        close_states(set, set.get_allocator().resource());
+    }
 
+    template <typename Set>
+    static void transit_into(const std::set<NFAState *> &states, Symbol *input, Set &to_states)
+    {
         for (NFAState *state : states)
         {
             auto iter = state->transitions().find(input);
@@ -79,6 +92,24 @@ namespace lr1cc
         }
 
         epsilon_close(to_states);
+    }
+
+    std::set<NFAState *> transit(const std::set<NFAState *> &states, Symbol *input)
+    {
+        std::set<NFAState *> to_states;
+
+        transit_into(states, input, to_states);
+
+        return to_states;
+    }
+
+    // The result lives in `resource', typically scratch memory for one
+    // DFA state; only sets that become new states are copied out.
+    std::pmr::set<NFAState *> transit(const std::set<NFAState *> &states, Symbol *input, std::pmr::memory_resource *resource)
+    {
+        std::pmr::set<NFAState *> to_states { resource };
+
+        transit_into(states, input, to_states);
 
         return to_states;
     }
@@ -88,24 +119,24 @@ namespace lr1cc
     }
 
     NFA::NFA(NFA &&nfa)
-        : m_start { nfa.m_start },
+        : m_starts { std::move(nfa.m_starts) },
           m_states { std::move(nfa.m_states) }
     {
-        nfa.m_start = nullptr;
+        nfa.m_starts.clear();
     }
 
     NFA &NFA::operator=(NFA &&nfa)
     {
-        m_start = nfa.m_start;
+        m_starts = std::move(nfa.m_starts);
         m_states = std::move(nfa.m_states);
 
-        nfa.m_start = nullptr;
+        nfa.m_starts.clear();
         return *this;
     }
     
-    NFAState *NFA::create_state(const Acceptance &acceptance)
+    NFAState *NFA::create_state(const Acceptance &acceptance, std::size_t core)
     {
-        auto ptr = std::make_unique<NFAState>(acceptance);
+        auto ptr = std::make_unique<NFAState>(acceptance, core);
         auto raw_ptr = ptr.get();
 
         m_states.push_back(std::move(ptr));
@@ -113,7 +144,62 @@ namespace lr1cc
         return raw_ptr;
     }
 
-    using NamedStateCatalog = std::unordered_map<std::pair<Symbol *, Symbol *>, NFAState *, PairHash<Symbol *, Symbol *>>;
+    // Frees the states reachable neither from the start states nor from
+    // `roots', and returns how many were freed.
+    std::size_t NFA::remove_unreachable_states(const std::vector<NFAState *> &roots)
+    {
+        std::unordered_set<NFAState *> reachable { m_starts.cbegin(), m_starts.cend() };
+        reachable.insert(roots.cbegin(), roots.cend());
+
+        std::deque<NFAState *> queue { reachable.cbegin(), reachable.cend() };
+
+        while (!queue.empty())
+        {
+            auto state = queue.front();
+            queue.pop_front();
+
+            for (const auto &[ input, to_states ] : state->transitions())
+            {
+                for (NFAState *to_state : to_states)
+                {
+                    if (reachable.emplace(to_state).second)
+                    {
+                        queue.push_back(to_state);
+                    }
+                }
+            }
+        }
+
+        return std::erase_if(
+            m_states,
+            [&](const std::unique_ptr<NFAState> &state) {
+                return !reachable.contains(state.get());
+            });
+    }
+
+    static std::size_t get_named_core(Symbol *lhs, CoreCatalog &cores)
+    {
+        auto [ iter, inserted ] = cores.named_cores.emplace(lhs, cores.next_core);
+
+        if (inserted)
+        {
+            ++cores.next_core;
+        }
+
+        return iter->second;
+    }
+
+    static std::size_t get_item_core(Production *p, std::size_t position, CoreCatalog &cores)
+    {
+        auto [ iter, inserted ] = cores.item_cores.emplace(std::pair { p, position }, cores.next_core);
+
+        if (inserted)
+        {
+            ++cores.next_core;
+        }
+
+        return iter->second;
+    }
 
     static auto lhs_is_equal_to_fn(Symbol *lhs)
     {
@@ -122,19 +208,25 @@ namespace lr1cc
         };
     }
     
-    static void grow_named_state(NFAState *state, Symbol *lhs, Symbol *follow, NFA &nfa, const Grammar &g, NamedStateCatalog &named_states);
+    static void grow_named_state(NFAState *state, Symbol *lhs, Symbol *follow, NFA &nfa, const Grammar &g, NFAConstruction &construction);
 
-    static NFAState *get_named_state(Symbol *lhs, Symbol *follow, NFA &nfa, const Grammar &g, NamedStateCatalog &named_states)
+    static NFAState *get_named_state(Symbol *lhs, Symbol *follow, NFA &nfa, const Grammar &g, NFAConstruction &construction)
     {
+        auto &named_states = construction.named_states;
         auto iter = named_states.find(std::pair { lhs, follow });
 
         if (iter == named_states.end())
         {
-            auto state = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr });
+            if (construction.budget != nullptr)
+            {
+                construction.budget->check_resources(static_cast<std::size_t>(std::ranges::distance(nfa.states())));
+            }
+
+            auto state = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr }, get_named_core(lhs, construction.cores));
 
             named_states.emplace(std::pair { lhs, follow }, state);
 
-            grow_named_state(state, lhs, follow, nfa, g, named_states);
+            grow_named_state(state, lhs, follow, nfa, g, construction);
 
             return state;
         }
@@ -144,68 +236,212 @@ namespace lr1cc
         }
     }
 
-    static void grow_named_state_by_production(NFAState *state, Production *p, Symbol *follow, NFA &nfa, const Grammar &g, NamedStateCatalog &named_states)
+    // Visits FIRST(suffix follow) in symbol order without building it.
+    template <typename F>
+    static void for_each_lookahead(const SuffixFirst &suffix, Symbol *follow, F f)
+    {
+        bool pending = suffix.nullable && !suffix.first.contains(follow);
+
+        for (Symbol *s : suffix.first)
+        {
+            if (pending && SymbolLess {}(follow, s))
+            {
+                f(follow);
+                pending = false;
+            }
+
+            f(s);
+        }
+
+        if (pending)
+        {
+            f(follow);
+        }
+    }
+
+    static void grow_named_state_by_production(NFAState *state, Production *p, Symbol *follow, NFA &nfa, const Grammar &g, NFAConstruction &construction)
     {
-        std::ranges::subrange rest_rhs { p->rhs };
-        
         auto prev_state = state;
+        std::size_t position = 0;
 
-        while (!rest_rhs.empty())
+        for (Symbol *curr_input : p->rhs)
         {
-            auto curr_input = rest_rhs.front();
-            rest_rhs = rest_rhs.next();
+            ++position;
 
-            auto curr_state = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr });
+            auto curr_state = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr }, get_item_core(p, position, construction.cores));
 
             prev_state->add_transition(curr_input, curr_state);
 
             if (curr_input->is_intermediate())
             {
-                auto rest_rhs_first = first(rest_rhs, follow);
-
-                for (Symbol *to_follow : rest_rhs_first)
-                {
-                    auto to_state = get_named_state(curr_input, to_follow, nfa, g, named_states);
-
-                    prev_state->add_transition(nullptr, to_state);
-                }
+                for_each_lookahead(
+                    construction.suffixes.at(p, position),
+                    follow,
+                    [&](Symbol *to_follow) {
+                        auto to_state = get_named_state(curr_input, to_follow, nfa, g, construction);
+
+                        prev_state->add_transition(nullptr, to_state);
+                    });
             }
 
             prev_state = curr_state;
         }
 
-        auto final_state = nfa.create_state(Acceptance { AcceptanceType::reduce, p });
+        auto final_state = nfa.create_state(Acceptance { AcceptanceType::reduce, p }, get_item_core(p, position + 1, construction.cores));
         
         prev_state->add_transition(follow, final_state);
     }
     
-    static void grow_named_state(NFAState *state, Symbol *lhs, Symbol *follow, NFA &nfa, const Grammar &g, NamedStateCatalog &named_states)
+    static void grow_named_state(NFAState *state, Symbol *lhs, Symbol *follow, NFA &nfa, const Grammar &g, NFAConstruction &construction)
     {
         std::ranges::for_each(
             g.productions() | std::ranges::views::filter(lhs_is_equal_to_fn(lhs)),
             [&](Production *p) {
-                grow_named_state_by_production(state, p, follow, nfa, g, named_states);
+                grow_named_state_by_production(state, p, follow, nfa, g, construction);
             });
     }
     
-    NFA grammar_to_nfa(const Grammar &g)
+    NFA grammar_to_nfa(const Grammar &g, NFAConstruction &construction)
     {
         NFA nfa;
 
-        NamedStateCatalog named_states;
+        construction.cores.next_core = 4;
+        construction.suffixes = SuffixFirstCatalog { g };
         
-        auto state1 = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr });
-        auto state2 = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr });
+        NFAState *state3 = nullptr;
+
+        // Every start symbol has its own entry state. The named states
+        // below them are shared, and so are the DFA states whose item
+        // sets coincide.
+        for (Symbol *start : g.starts())
+        {
+            auto first = state3 == nullptr;
+            auto state1 = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr }, first ? 1 : construction.cores.next_core++);
+            auto state2 = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr }, first ? 2 : construction.cores.next_core++);
+
+            if (first)
+            {
+                state3 = nfa.create_state(Acceptance { AcceptanceType::accept, nullptr }, 3);
+            }
+
+            auto state4 = get_named_state(start, g.end(), nfa, g, construction);
+
+            state1->add_transition(start, state2);
+            state2->add_transition(g.end(), state3);
+            state1->add_transition(nullptr, state4);
+
+            nfa.add_start(state1);
+        }
+
+        return nfa;
+    }
+
+    NFA grammar_to_nfa(const Grammar &g, HashTableStats *stats, Budget *budget)
+    {
+        NFAConstruction construction;
+        construction.budget = budget;
+
+        auto nfa = grammar_to_nfa(g, construction);
+
+        if (stats != nullptr)
+        {
+            *stats = hash_table_stats(construction.named_states);
+        }
+
+        return nfa;
+    }
+
+    // One named state per nonterminal and one final state per
+    // production, reached on every symbol of FOLLOW(lhs): the subset
+    // construction of this NFA is the SLR(1) automaton.
+    NFA grammar_to_slr_nfa(const Grammar &g)
+    {
+        NFA nfa;
+
+        auto follows = follow_sets(g, SuffixFirstCatalog { g });
+        std::unordered_map<Symbol *, NFAState *> named_states;
+
+        auto get_slr_named_state = [&](Symbol *lhs) {
+            auto [ iter, inserted ] = named_states.emplace(lhs, nullptr);
+
+            if (inserted)
+            {
+                iter->second = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr });
+            }
+
+            return iter->second;
+        };
+
         auto state3 = nfa.create_state(Acceptance { AcceptanceType::accept, nullptr });
-        auto state4 = get_named_state(g.start(), g.end(), nfa, g, named_states);
 
-        state1->add_transition(g.start(), state2);
-        state2->add_transition(g.end(), state3);
-        state1->add_transition(nullptr, state4);
+        for (Symbol *start : g.starts())
+        {
+            auto state1 = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr });
+            auto state2 = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr });
+            auto state4 = get_slr_named_state(start);
+
+            state1->add_transition(start, state2);
+            state2->add_transition(g.end(), state3);
+            state1->add_transition(nullptr, state4);
+
+            nfa.add_start(state1);
+        }
+
+        for (Production *p : g.productions())
+        {
+            auto prev_state = get_slr_named_state(p->lhs);
+
+            for (Symbol *curr_input : p->rhs)
+            {
+                auto curr_state = nfa.create_state(Acceptance { AcceptanceType::reject, nullptr });
+
+                prev_state->add_transition(curr_input, curr_state);
 
-        nfa.set_start(state1);
+                if (curr_input->is_intermediate())
+                {
+                    prev_state->add_transition(nullptr, get_slr_named_state(curr_input));
+                }
+
+                prev_state = curr_state;
+            }
+
+            auto final_state = nfa.create_state(Acceptance { AcceptanceType::reduce, p });
+
+            for (Symbol *follow : follows[p->lhs])
+            {
+                prev_state->add_transition(follow, final_state);
+            }
+        }
 
         return nfa;
     }
+
+    std::vector<NFAState *> regrow_named_states(const std::set<Symbol *, SymbolLess> &lhs_set, NFA &nfa, const Grammar &g, NFAConstruction &construction)
+    {
+        std::vector<std::pair<std::pair<Symbol *, Symbol *>, NFAState *>> regrown;
+
+        for (const auto &pair : construction.named_states)
+        {
+            if (lhs_set.contains(pair.first.first))
+            {
+                regrown.push_back(pair);
+            }
+        }
+
+        std::vector<NFAState *> states;
+
+        construction.suffixes = SuffixFirstCatalog { g };
+
+        for (const auto &[ key, state ] : regrown)
+        {
+            state->transitions().clear();
+
+            grow_named_state(state, key.first, key.second, nfa, g, construction);
+
+            states.push_back(state);
+        }
+
+        return states;
+    }
     
 }
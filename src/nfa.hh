@@ -3,12 +3,17 @@
 
 #include "symbol.hh"
 #include "grammar.hh"
+#include "budget.hh"
+#include "util.hh"
 
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <ranges>
 #include <set>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace lr1cc
@@ -27,17 +32,18 @@ namespace lr1cc
 
     class NFAState;
 
-    using NFATransitionCatalog = std::map<Symbol *, std::set<NFAState *>>;
+    using NFATransitionCatalog = std::map<Symbol *, std::set<NFAState *>, SymbolLess>;
     
     class NFAState
     {
 
         Acceptance m_acceptance;
+        std::size_t m_core;
         NFATransitionCatalog m_transitions;
 
     public:
 
-        NFAState(const Acceptance &);
+        NFAState(const Acceptance &, std::size_t = 0);
         
         NFAState(const NFAState &) = delete;
         NFAState(NFAState &&) = delete;
@@ -47,6 +53,8 @@ namespace lr1cc
 
         const Acceptance &acceptance() const;
 
+        std::size_t core() const;
+
         const NFATransitionCatalog &transitions() const;
         NFATransitionCatalog &transitions();
 
@@ -55,12 +63,15 @@ namespace lr1cc
     };
 
     void epsilon_close(std::set<NFAState *> &);
+    void epsilon_close(std::pmr::set<NFAState *> &);
+
     std::set<NFAState *> transit(const std::set<NFAState *> &, Symbol *);
+    std::pmr::set<NFAState *> transit(const std::set<NFAState *> &, Symbol *, std::pmr::memory_resource *);
     
     class NFA
     {
 
-        NFAState *m_start;
+        std::vector<NFAState *> m_starts;
         std::vector<std::unique_ptr<NFAState>> m_states;
 
     public:
@@ -75,8 +86,15 @@ namespace lr1cc
 
         NFAState *start() const;
         void set_start(NFAState *);
+
+        const std::vector<NFAState *> &starts() const;
+        void add_start(NFAState *);
         
-        NFAState *create_state(const Acceptance &);
+        NFAState *create_state(const Acceptance &, std::size_t = 0);
+
+        std::size_t remove_unreachable_states(const std::vector<NFAState *> &);
+
+        auto states() const;
 
         template <typename R>
         requires std::ranges::input_range<std::remove_reference_t<R>>
@@ -84,13 +102,42 @@ namespace lr1cc
         
     };
 
-    NFA grammar_to_nfa(const Grammar &);
+    using NamedStateCatalog = std::unordered_map<std::pair<Symbol *, Symbol *>, NFAState *, PairHash<Symbol *, Symbol *>>;
+
+    // NFA states which differ only in their follow symbols share a core.
+    // Cores identify the LR(0) items which LALR(1) construction merges.
+    struct CoreCatalog
+    {
+        std::unordered_map<Symbol *, std::size_t> named_cores;
+        std::unordered_map<std::pair<Production *, std::size_t>, std::size_t, PairHash<Production *, std::size_t>> item_cores;
+        std::size_t next_core;
+    };
+
+    struct NFAConstruction
+    {
+        NamedStateCatalog named_states;
+        CoreCatalog cores;
+        SuffixFirstCatalog suffixes;
+        Budget *budget = nullptr;
+    };
+
+    NFA grammar_to_nfa(const Grammar &, NFAConstruction &);
+    NFA grammar_to_nfa(const Grammar &, HashTableStats * = nullptr, Budget * = nullptr);
+
+    NFA grammar_to_slr_nfa(const Grammar &);
+
+    std::vector<NFAState *> regrow_named_states(const std::set<Symbol *, SymbolLess> &, NFA &, const Grammar &, NFAConstruction &);
     
     inline const Acceptance &NFAState::acceptance() const
     {
         return m_acceptance;
     }
 
+    inline std::size_t NFAState::core() const
+    {
+        return m_core;
+    }
+
     inline const NFATransitionCatalog &NFAState::transitions() const
     {
         return m_transitions;
@@ -103,19 +150,38 @@ namespace lr1cc
     
     inline NFAState *NFA::start() const
     {
-        return m_start;
+        return m_starts.empty() ? nullptr : m_starts.front();
     }
     
     inline void NFA::set_start(NFAState *s)
     {
-        m_start = s;
+        m_starts = { s };
+    }
+
+    inline const std::vector<NFAState *> &NFA::starts() const
+    {
+        return m_starts;
+    }
+
+    inline void NFA::add_start(NFAState *s)
+    {
+        m_starts.push_back(s);
+    }
+
+    inline auto NFA::states() const
+    {
+        auto raw_pointer = [](const std::unique_ptr<NFAState> &p) {
+            return p.get();
+        };
+
+        return m_states | std::ranges::views::transform(raw_pointer);
     }
 
     template <typename R>
     requires std::ranges::input_range<std::remove_reference_t<R>>
     std::set<NFAState *> NFA::run(R &&inputs) const
     {
-        std::set states { m_start };
+        std::set states { start() };
         epsilon_close(states);
 
         for (Symbol *input : inputs)
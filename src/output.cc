@@ -1,30 +1,56 @@
 
 #include "output.hh"
 
-#include <deque>
+#include <algorithm>
+#include <ranges>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
 namespace lr1cc
 {
 
-    static std::unordered_map<DFAState *, std::size_t> name_states(const DFA &dfa)
+    static std::unordered_map<DFAState *, std::size_t> name_states(const TableLayout &layout)
     {
         std::unordered_map<DFAState *, std::size_t> state_to_name;
 
-        for_each_dfa_state(
-            dfa.start(),
-            [&](DFAState *state) {
-                if (state->rejects())
-                {
-                    std::size_t name = state_to_name.size() + 1;
-                    state_to_name.emplace(state, name);
-                }
-            });
+        for (DFAState *state : layout.rows)
+        {
+            std::size_t name = state_to_name.size() + 1;
+            state_to_name.emplace(state, name);
+        }
 
         return state_to_name;
     }
 
+    std::vector<Symbol *> table_columns(const SymbolManager &manager)
+    {
+        std::vector<Symbol *> columns;
+
+        auto push_column = [&](Symbol *s) {
+            columns.push_back(s);
+        };
+    
+        auto symbol_is_terminal = [](Symbol *s) {
+            return s->is_terminal() && !s->is_useless();
+        };
+
+        auto symbol_is_intermediate = [](Symbol *s) {
+            return s->is_intermediate() && !s->is_useless();
+        };
+    
+        std::ranges::for_each(
+            manager.symbols() | std::ranges::views::filter(symbol_is_terminal),
+            push_column);
+
+        std::ranges::for_each(
+            manager.symbols() | std::ranges::views::filter(symbol_is_intermediate),
+            push_column);
+    
+        return columns;
+    }
+
     void output_lr1_table_header(const std::vector<Symbol *> &columns, std::ostream &out)
     {
         for (const auto &column : columns)
@@ -74,22 +100,84 @@ namespace lr1cc
         out << "\r\n";
     }
     
-    void output_lr1_table(const DFA &dfa, const std::vector<Symbol *> &columns, std::ostream &out)
+    std::vector<std::string> lr1_table_rows(const TableLayout &layout)
+    {
+        auto state_to_name = name_states(layout);
+
+        std::vector<std::string> rows;
+
+        for (DFAState *state : layout.rows)
+        {
+            std::ostringstream row;
+
+            output_lr1_table_row(state, layout.columns, state_to_name, row);
+
+            rows.push_back(row.str());
+        }
+
+        return rows;
+    }
+
+    std::vector<std::string> lr1_table_rows(const DFA &dfa, const std::vector<Symbol *> &columns)
+    {
+        return lr1_table_rows(bfs_layout(dfa, columns));
+    }
+
+    void output_lr1_table(const TableLayout &layout, std::ostream &out)
     {
-        auto state_to_name = name_states(dfa);
+        auto state_to_name = name_states(layout);
         
-        output_lr1_table_header(columns, out);
+        output_lr1_table_header(layout.columns, out);
+
+        for (DFAState *state : layout.rows)
+        {
+            output_lr1_table_row(state, layout.columns, state_to_name, out);
+        }
+
+        out << std::flush;
+    }
+
+    void output_lr1_table(const DFA &dfa, const std::vector<Symbol *> &columns, std::ostream &out)
+    {
+        output_lr1_table(bfs_layout(dfa, columns), out);
+    }
+    
+    TableStats lr1_table_stats(const TableLayout &layout)
+    {
+        auto state_to_name = name_states(layout);
 
-        for_each_dfa_state(
-            dfa.start(),
-            [&](DFAState *state) {
-                if (state->rejects())
+        TableStats stats { state_to_name.size(), layout.columns.size(), 0, 0 };
+        std::unordered_set<std::string> rows;
+
+        for (DFAState *state : layout.rows)
+        {
+            std::ostringstream row;
+
+            for (Symbol *column : layout.columns)
+            {
+                std::ostringstream cell;
+
+                output_lr1_table_cell(state, column, state_to_name, cell);
+
+                if (!cell.view().empty())
                 {
-                    output_lr1_table_row(state, columns, state_to_name, out);
+                    ++stats.filled_cells;
                 }
-            });
 
-        out << std::flush;
+                row << cell.view() << ',';
+            }
+
+            rows.emplace(row.str());
+        }
+
+        stats.distinct_rows = rows.size();
+
+        return stats;
+    }
+
+    TableStats lr1_table_stats(const DFA &dfa, const std::vector<Symbol *> &columns)
+    {
+        return lr1_table_stats(bfs_layout(dfa, columns));
     }
     
 }
@@ -2,14 +2,36 @@
 #define LR1CC_INCLUDE_OUTPUT_HH
 
 #include "dfa.hh"
+#include "layout.hh"
 
 #include <iostream>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace lr1cc
 {
 
+    struct TableStats
+    {
+        std::size_t rows;
+        std::size_t columns;
+        std::size_t filled_cells;
+        std::size_t distinct_rows;
+    };
+
+    std::vector<Symbol *> table_columns(const SymbolManager &);
+
+    void output_lr1_table_row(DFAState *, const std::vector<Symbol *> &, std::unordered_map<DFAState *, std::size_t> &, std::ostream &);
+
+    void output_lr1_table(const TableLayout &, std::ostream &);
     void output_lr1_table(const DFA &, const std::vector<Symbol *> &, std::ostream &);
+
+    std::vector<std::string> lr1_table_rows(const TableLayout &);
+    std::vector<std::string> lr1_table_rows(const DFA &, const std::vector<Symbol *> &);
+
+    TableStats lr1_table_stats(const TableLayout &);
+    TableStats lr1_table_stats(const DFA &, const std::vector<Symbol *> &);
     
 }
 
@@ -0,0 +1,98 @@
+#include "recovery.hh"
+
+#include <algorithm>
+
+namespace lr1cc
+{
+
+    RecoveryTable::RecoveryTable(const ParseTable &table)
+        : m_terminals { static_cast<std::size_t>(std::ranges::count_if(table.columns(), [](Symbol *s) { return s->is_terminal(); })) },
+          m_words { (m_terminals + 63) / 64 },
+          m_expected(table.rows() * m_words, 0),
+          m_insertion_offsets { 0 },
+          m_sync_offsets { 0 }
+    {
+        for (std::size_t row = 0; row < table.rows(); ++row)
+        {
+            for (std::size_t column = 0; column < table.columns().size(); ++column)
+            {
+                auto actions = table.actions(row, column);
+
+                if (actions.empty())
+                {
+                    continue;
+                }
+
+                if (column < m_terminals)
+                {
+                    m_expected[row * m_words + column / 64] |= std::uint64_t { 1 } << (column % 64);
+                }
+
+                for (const Action &action : actions)
+                {
+                    if (action.type == ActionType::shift)
+                    {
+                        m_insertions.push_back(Insertion { static_cast<std::uint32_t>(column), static_cast<std::uint32_t>(action.state) });
+                    }
+                    else if (action.type == ActionType::go)
+                    {
+                        m_sync_points.push_back(SyncPoint { static_cast<std::uint32_t>(column), static_cast<std::uint32_t>(action.state) });
+                    }
+                }
+            }
+
+            m_insertion_offsets.push_back(m_insertions.size());
+            m_sync_offsets.push_back(m_sync_points.size());
+        }
+    }
+
+    // The bitset is written as hexadecimal digits, the first digit
+    // holding the first four terminal columns with the lowest bit
+    // for the first column.
+    static void output_expected(std::span<const std::uint64_t> expected, std::size_t terminals, std::ostream &out)
+    {
+        static constexpr char digits[] = "0123456789abcdef";
+
+        for (std::size_t column = 0; column < terminals; column += 4)
+        {
+            out << digits[expected[column / 64] >> (column % 64) & 0xf];
+        }
+    }
+
+    void output_recovery_table(const ParseTable &table, const RecoveryTable &recovery, std::ostream &out)
+    {
+        out << ",expected,insert,sync\r\n";
+
+        for (std::size_t row = 0; row < table.rows(); ++row)
+        {
+            out << row + 1 << ',';
+
+            output_expected(recovery.expected(row), recovery.terminals(), out);
+
+            out << ',';
+
+            const char *separator = "";
+
+            for (const Insertion &insertion : recovery.insertions(row))
+            {
+                out << separator << table.columns()[insertion.terminal]->name();
+                separator = "/";
+            }
+
+            out << ',';
+
+            separator = "";
+
+            for (const SyncPoint &sync : recovery.sync_points(row))
+            {
+                out << separator << table.columns()[sync.nonterminal]->name();
+                separator = "/";
+            }
+
+            out << "\r\n";
+        }
+
+        out << std::flush;
+    }
+
+}
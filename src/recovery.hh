@@ -0,0 +1,94 @@
+#ifndef LR1CC_INCLUDE_RECOVERY_HH
+#define LR1CC_INCLUDE_RECOVERY_HH
+
+#include "table.hh"
+
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+
+namespace lr1cc
+{
+
+    // A terminal that can be inserted before an unexpected token and
+    // the row its shift moves to.
+    struct Insertion
+    {
+        std::uint32_t terminal;
+        std::uint32_t row;
+    };
+
+    // A nonterminal the input skipped at an error can stand for and
+    // the row its goto moves to.
+    struct SyncPoint
+    {
+        std::uint32_t nonterminal;
+        std::uint32_t row;
+    };
+
+    // Precomputed error handling data of a parsing table: for every
+    // row, the bitset of terminals with an action, the terminals it
+    // shifts, which are the candidates for insertion, and the
+    // nonterminals it has a goto on, which are the synchronization
+    // points of panic mode recovery. Columns are those of the table.
+    class RecoveryTable
+    {
+
+        std::size_t m_terminals;
+        std::size_t m_words;
+        std::vector<std::uint64_t> m_expected;
+        std::vector<std::size_t> m_insertion_offsets;
+        std::vector<Insertion> m_insertions;
+        std::vector<std::size_t> m_sync_offsets;
+        std::vector<SyncPoint> m_sync_points;
+
+    public:
+
+        explicit RecoveryTable(const ParseTable &);
+
+        std::size_t terminals() const;
+
+        std::span<const std::uint64_t> expected(std::size_t) const;
+        bool expects(std::size_t, std::size_t) const;
+
+        std::span<const Insertion> insertions(std::size_t) const;
+        std::span<const SyncPoint> sync_points(std::size_t) const;
+
+    };
+
+    void output_recovery_table(const ParseTable &, const RecoveryTable &, std::ostream &);
+
+    inline std::size_t RecoveryTable::terminals() const
+    {
+        return m_terminals;
+    }
+
+    inline std::span<const std::uint64_t> RecoveryTable::expected(std::size_t row) const
+    {
+        return std::span<const std::uint64_t> { m_expected.data() + row * m_words, m_words };
+    }
+
+    inline bool RecoveryTable::expects(std::size_t row, std::size_t column) const
+    {
+        if (column >= m_terminals)
+        {
+            return false;
+        }
+
+        return (m_expected[row * m_words + column / 64] >> (column % 64) & 1) != 0;
+    }
+
+    inline std::span<const Insertion> RecoveryTable::insertions(std::size_t row) const
+    {
+        return std::span<const Insertion> { m_insertions.data() + m_insertion_offsets[row], m_insertions.data() + m_insertion_offsets[row + 1] };
+    }
+
+    inline std::span<const SyncPoint> RecoveryTable::sync_points(std::size_t row) const
+    {
+        return std::span<const SyncPoint> { m_sync_points.data() + m_sync_offsets[row], m_sync_points.data() + m_sync_offsets[row + 1] };
+    }
+
+}
+
+#endif
@@ -0,0 +1,262 @@
+#include "reparse.hh"
+
+#include <limits>
+#include <stdexcept>
+
+namespace lr1cc
+{
+
+    static constexpr std::uint32_t no_node = std::numeric_limits<std::uint32_t>::max();
+
+    // The next item of the input: a token, or an old subtree when `node'
+    // is set. Replacement tokens come from the edited range.
+    struct StreamItem
+    {
+        std::uint32_t symbol;
+        std::uint32_t node;
+        bool replacement;
+    };
+
+    IncrementalParser::IncrementalParser(const ParseTable &table, std::size_t entry)
+        : m_table { table },
+          m_entry { entry }
+    {
+    }
+
+    std::uint32_t IncrementalParser::create_node(std::uint32_t symbol, const Production *production, std::size_t state, std::size_t length)
+    {
+        if (m_free_nodes.empty())
+        {
+            m_nodes.push_back(ParseNode { symbol, production, state, length, { } });
+            return static_cast<std::uint32_t>(m_nodes.size() - 1);
+        }
+
+        auto index = m_free_nodes.back();
+        m_free_nodes.pop_back();
+
+        auto &node = m_nodes[index];
+
+        node.symbol = symbol;
+        node.production = production;
+        node.state = state;
+        node.length = length;
+        node.children.clear();
+
+        return index;
+    }
+
+    ParseResult IncrementalParser::parse(std::span<const std::uint32_t> input)
+    {
+        m_tokens.assign(input.begin(), input.end());
+        m_root.reset();
+
+        return run(0, 0, 0);
+    }
+
+    ParseResult IncrementalParser::edit(std::size_t begin, std::size_t end, std::span<const std::uint32_t> replacement)
+    {
+        if (begin > end || end > m_tokens.size())
+        {
+            throw std::runtime_error { "error: the edited range is out of the input.\n" };
+        }
+
+        m_tokens.erase(m_tokens.begin() + static_cast<std::ptrdiff_t>(begin), m_tokens.begin() + static_cast<std::ptrdiff_t>(end));
+        m_tokens.insert(m_tokens.begin() + static_cast<std::ptrdiff_t>(begin), replacement.begin(), replacement.end());
+
+        return run(begin, end, begin + replacement.size());
+    }
+
+    // The old tokens [begin, old_end) have been replaced by the tokens
+    // [begin, new_end) of m_tokens. The input is read from the old tree,
+    // left to right, with subtrees that overlap the edit or end just
+    // before it broken down; the old tokens after the tree are read
+    // from m_tokens. Without an old tree, every token is read.
+    ParseResult IncrementalParser::run(std::size_t begin, std::size_t old_end, std::size_t new_end)
+    {
+        ParseResult result { false, 0, 0 };
+
+        m_pending.clear();
+
+        if (m_root.has_value())
+        {
+            m_pending.push_back(m_root.value());
+        }
+        else
+        {
+            m_nodes.clear();
+            m_free_nodes.clear();
+        }
+
+        m_root.reset();
+        m_stack.clear();
+        m_stack.emplace_back(m_entry, no_node);
+
+        auto old_size = m_tokens.size() + old_end - new_end;
+        std::size_t old_position = 0;
+        std::size_t next_replacement = begin;
+
+        auto break_down = [&]() {
+            auto index = m_pending.back();
+            m_pending.pop_back();
+
+            const auto &children = m_nodes[index].children;
+            m_pending.insert(m_pending.end(), children.rbegin(), children.rend());
+
+            m_free_nodes.push_back(index);
+        };
+
+        auto front = [&]() -> std::optional<StreamItem> {
+            while (true)
+            {
+                if (old_position >= begin && next_replacement < new_end)
+                {
+                    return StreamItem { m_tokens[next_replacement], no_node, true };
+                }
+
+                auto edited = old_position >= begin && old_position < old_end;
+
+                if (m_pending.empty())
+                {
+                    if (old_position >= old_size)
+                    {
+                        return std::nullopt;
+                    }
+
+                    if (edited)
+                    {
+                        ++old_position;
+                        continue;
+                    }
+
+                    auto index = old_position < begin ? old_position : old_position - old_end + new_end;
+                    return StreamItem { m_tokens[index], no_node, false };
+                }
+
+                auto index = m_pending.back();
+                const auto &node = m_nodes[index];
+
+                if (node.production == nullptr)
+                {
+                    if (!edited)
+                    {
+                        return StreamItem { node.symbol, index, false };
+                    }
+
+                    m_pending.pop_back();
+                    m_free_nodes.push_back(index);
+                    ++old_position;
+                    continue;
+                }
+
+                if (node.length != 0 && (old_position + node.length < begin || old_position >= old_end))
+                {
+                    return StreamItem { node.symbol, index, false };
+                }
+
+                break_down();
+            }
+        };
+
+        auto advance = [&](const StreamItem &item) {
+            if (item.replacement)
+            {
+                ++next_replacement;
+            }
+            else if (item.node != no_node)
+            {
+                m_pending.pop_back();
+                old_position += m_nodes[item.node].length;
+            }
+            else
+            {
+                ++old_position;
+            }
+        };
+
+        while (true)
+        {
+            auto item = front();
+
+            if (!item.has_value())
+            {
+                return result;
+            }
+
+            auto state = m_stack.back().first;
+
+            if (item->node != no_node && m_nodes[item->node].production != nullptr)
+            {
+                const auto &node = m_nodes[item->node];
+                auto to_row = node.state == state ? m_table.go(state, node.symbol) : std::nullopt;
+
+                if (to_row.has_value())
+                {
+                    m_stack.emplace_back(to_row.value(), item->node);
+                    result.position += node.length;
+                    advance(item.value());
+                }
+                else
+                {
+                    break_down();
+                }
+
+                continue;
+            }
+
+            if (item->symbol >= m_table.columns().size() || m_table.actions(state, item->symbol).empty())
+            {
+                return result;
+            }
+
+            const Action &action = m_table.actions(state, item->symbol).front();
+
+            switch (action.type)
+            {
+            case ActionType::shift:
+            {
+                auto index = item->node;
+
+                if (index == no_node)
+                {
+                    index = create_node(item->symbol, nullptr, state, 1);
+                }
+                else
+                {
+                    m_nodes[index].state = state;
+                }
+
+                m_stack.emplace_back(action.state, index);
+                ++result.position;
+                advance(item.value());
+                break;
+            }
+            case ActionType::accept:
+                m_root = m_stack.back().second;
+                result.accepted = true;
+                return result;
+            case ActionType::reduce:
+            {
+                auto length = action.production->rhs.size();
+                auto first = m_stack.size() - length;
+                auto from = m_stack[first - 1].first;
+                auto index = create_node(static_cast<std::uint32_t>(action.state), action.production, from, 0);
+                auto &node = m_nodes[index];
+
+                for (auto i = first; i < m_stack.size(); ++i)
+                {
+                    node.children.push_back(m_stack[i].second);
+                    node.length += m_nodes[m_stack[i].second].length;
+                }
+
+                m_stack.resize(first);
+                m_stack.emplace_back(m_table.go(from, action.state).value(), index);
+                ++result.reductions;
+                break;
+            }
+            case ActionType::go:
+                return result;
+            }
+        }
+    }
+
+}
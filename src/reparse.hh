@@ -0,0 +1,84 @@
+#ifndef LR1CC_INCLUDE_REPARSE_HH
+#define LR1CC_INCLUDE_REPARSE_HH
+
+#include "runtime.hh"
+#include "table.hh"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace lr1cc
+{
+
+    // A node of the parse tree kept by IncrementalParser. `symbol' is a
+    // column of the table, `state' the row on the top of the stack when
+    // the node was pushed and `length' the number of tokens it spans.
+    // Terminal nodes have no production.
+    struct ParseNode
+    {
+        std::uint32_t symbol;
+        const Production *production;
+        std::size_t state;
+        std::size_t length;
+        std::vector<std::uint32_t> children;
+    };
+
+    // An LR parser that keeps the parse tree of the last accepted input
+    // and, after an edit of a token range, shifts each subtree outside
+    // the edit as a whole when the state it was pushed in is on the top
+    // of the stack again (Wagner and Graham). A subtree is reused only
+    // when the token after it is unchanged too, since its last
+    // reductions were made on that lookahead. The End-Of-Tokens token
+    // ends the input and is not part of the tree.
+    class IncrementalParser
+    {
+
+        const ParseTable &m_table;
+        std::size_t m_entry;
+        std::vector<std::uint32_t> m_tokens;
+        std::vector<ParseNode> m_nodes;
+        std::vector<std::uint32_t> m_free_nodes;
+        std::optional<std::uint32_t> m_root;
+        std::vector<std::pair<std::size_t, std::uint32_t>> m_stack;
+        std::vector<std::uint32_t> m_pending;
+
+        std::uint32_t create_node(std::uint32_t, const Production *, std::size_t, std::size_t);
+        ParseResult run(std::size_t, std::size_t, std::size_t);
+
+    public:
+
+        explicit IncrementalParser(const ParseTable &, std::size_t = 0);
+
+        IncrementalParser(const IncrementalParser &) = delete;
+        IncrementalParser &operator=(const IncrementalParser &) = delete;
+
+        ParseResult parse(std::span<const std::uint32_t>);
+        ParseResult edit(std::size_t, std::size_t, std::span<const std::uint32_t>);
+
+        const std::vector<std::uint32_t> &tokens() const;
+
+        std::optional<std::uint32_t> root() const;
+        const ParseNode &node(std::uint32_t) const;
+
+    };
+
+    inline const std::vector<std::uint32_t> &IncrementalParser::tokens() const
+    {
+        return m_tokens;
+    }
+
+    inline std::optional<std::uint32_t> IncrementalParser::root() const
+    {
+        return m_root;
+    }
+
+    inline const ParseNode &IncrementalParser::node(std::uint32_t index) const
+    {
+        return m_nodes[index];
+    }
+
+}
+
+#endif
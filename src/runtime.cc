@@ -0,0 +1,395 @@
+#include "runtime.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <thread>
+
+namespace lr1cc
+{
+
+    TableProfile::TableProfile(const ParseTable &table)
+        : row_hits(table.rows(), 0),
+          column_hits(table.columns().size(), 0)
+    {
+    }
+
+    // Replaces the nodes of the right-hand side on the top of `nodes'
+    // with the node of the reduction.
+    static void reduce_node(ParseTree &tree, std::vector<std::uint32_t> &nodes, const Action &action, std::size_t position)
+    {
+        auto length = action.production->rhs.size();
+        auto first = nodes.end() - static_cast<std::ptrdiff_t>(length);
+
+        TreeNode node { static_cast<std::uint32_t>(action.state), action.production, position, 0, static_cast<std::uint32_t>(tree.children.size()), static_cast<std::uint32_t>(length) };
+
+        if (length != 0)
+        {
+            const auto &front = tree.nodes[*first];
+            const auto &back = tree.nodes[nodes.back()];
+
+            node.begin = front.begin;
+            node.length = back.begin + back.length - front.begin;
+        }
+
+        tree.children.insert(tree.children.end(), first, nodes.end());
+        nodes.erase(first, nodes.end());
+
+        nodes.push_back(static_cast<std::uint32_t>(tree.nodes.size()));
+        tree.nodes.push_back(node);
+    }
+
+    LRParser::LRParser(const ParseTable &table, TableProfile *profile)
+        : m_table { table },
+          m_profile { profile }
+    {
+    }
+
+    // A token without an action is first repaired by inserting a
+    // terminal after which it is expected, then by deleting it when the
+    // next token is expected, and then by synchronization on the first
+    // token expected after the goto of a row on the stack. Another
+    // error at the same position only tries repairs that consume input,
+    // so parsing always ends.
+    bool LRParser::recover(std::span<const std::uint32_t> input, ParseResult &result, bool retry, const RecoveryTable &recovery, std::vector<ParseError> &errors)
+    {
+        auto row = m_stack.back();
+        auto position = result.position;
+        auto token = input[position];
+
+        ParseError error { position, row, RepairType::none, token, 0 };
+
+        if (!retry)
+        {
+            for (const Insertion &insertion : recovery.insertions(row))
+            {
+                if (recovery.expects(insertion.row, token))
+                {
+                    m_stack.push_back(insertion.row);
+
+                    error.repair = RepairType::insertion;
+                    error.symbol = insertion.terminal;
+                    errors.push_back(error);
+                    return true;
+                }
+            }
+        }
+
+        if (position + 1 < input.size() && recovery.expects(row, input[position + 1]))
+        {
+            ++result.position;
+
+            error.repair = RepairType::deletion;
+            error.skipped = 1;
+            errors.push_back(error);
+            return true;
+        }
+
+        for (auto next = retry ? position + 1 : position; next < input.size(); ++next)
+        {
+            for (auto depth = m_stack.size(); depth-- > 0;)
+            {
+                for (const SyncPoint &sync : recovery.sync_points(m_stack[depth]))
+                {
+                    if (!recovery.expects(sync.row, input[next]))
+                    {
+                        continue;
+                    }
+
+                    m_stack.resize(depth + 1);
+                    m_stack.push_back(sync.row);
+                    result.position = next;
+
+                    error.repair = RepairType::synchronization;
+                    error.symbol = sync.nonterminal;
+                    error.skipped = next - position;
+                    errors.push_back(error);
+                    return true;
+                }
+            }
+        }
+
+        errors.push_back(error);
+        return false;
+    }
+
+    // With a tree, m_nodes holds the node of every stack entry above
+    // the entry row. Recovery changes the stack without nodes, so the
+    // two are never used together.
+    ParseResult LRParser::run(std::span<const std::uint32_t> input, std::size_t entry, const RecoveryTable *recovery, std::vector<ParseError> *errors, ParseTree *tree)
+    {
+        ParseResult result { false, 0, 0 };
+        auto error_position = input.size();
+
+        m_stack.clear();
+        m_stack.push_back(entry);
+        m_nodes.clear();
+
+        while (result.position < input.size())
+        {
+            auto column = input[result.position];
+            auto state = m_stack.back();
+
+            auto handle_error = [&]() {
+                auto position = result.position;
+
+                if (recovery == nullptr || !recover(input, result, error_position == position, *recovery, *errors))
+                {
+                    return false;
+                }
+
+                error_position = position;
+                return true;
+            };
+
+            if (column >= m_table.columns().size())
+            {
+                if (!handle_error())
+                {
+                    return result;
+                }
+
+                continue;
+            }
+
+            if (m_profile != nullptr)
+            {
+                ++m_profile->row_hits[state];
+                ++m_profile->column_hits[column];
+            }
+
+            auto actions = m_table.actions(state, column);
+
+            if (actions.empty())
+            {
+                if (!handle_error())
+                {
+                    return result;
+                }
+
+                continue;
+            }
+
+            const Action &action = actions.front();
+
+            switch (action.type)
+            {
+            case ActionType::shift:
+                if (tree != nullptr)
+                {
+                    m_nodes.push_back(static_cast<std::uint32_t>(tree->nodes.size()));
+                    tree->nodes.push_back(TreeNode { column, nullptr, result.position, 1, 0, 0 });
+                }
+
+                m_stack.push_back(action.state);
+                ++result.position;
+                break;
+            case ActionType::accept:
+                if (tree != nullptr && !m_nodes.empty())
+                {
+                    tree->root = m_nodes.back();
+                }
+
+                result.accepted = true;
+                return result;
+            case ActionType::reduce:
+                if (tree != nullptr)
+                {
+                    reduce_node(*tree, m_nodes, action, result.position);
+                }
+
+                m_stack.resize(m_stack.size() - action.production->rhs.size());
+
+                if (m_profile != nullptr)
+                {
+                    ++m_profile->row_hits[m_stack.back()];
+                    ++m_profile->column_hits[action.state];
+                }
+
+                m_stack.push_back(m_table.go(m_stack.back(), action.state).value());
+                ++result.reductions;
+                break;
+            case ActionType::go:
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+    ParseResult LRParser::parse(std::span<const std::uint32_t> input, std::size_t entry)
+    {
+        return run(input, entry, nullptr, nullptr, nullptr);
+    }
+
+    ParseResult LRParser::parse(std::span<const std::uint32_t> input, const RecoveryTable &recovery, std::vector<ParseError> &errors, std::size_t entry)
+    {
+        return run(input, entry, &recovery, &errors, nullptr);
+    }
+
+    // The tree is cleared first but keeps its capacity, so a tree
+    // reused across inputs stops allocating once it has grown.
+    ParseResult LRParser::parse(std::span<const std::uint32_t> input, ParseTree &tree, std::size_t entry)
+    {
+        tree.clear();
+
+        return run(input, entry, nullptr, nullptr, &tree);
+    }
+
+    ParseResult LRParser::parse(std::span<Symbol *const> input, std::size_t entry)
+    {
+        m_columns.clear();
+
+        for (Symbol *s : input)
+        {
+            auto column = m_table.column(s);
+            m_columns.push_back(static_cast<std::uint32_t>(column.value_or(std::numeric_limits<std::uint32_t>::max())));
+        }
+
+        return parse(std::span<const std::uint32_t> { m_columns }, entry);
+    }
+
+    // Workers claim inputs in chunks, so a batch of many short inputs
+    // does not contend on the counter, and write to disjoint results.
+    // Each worker builds trees in its own arena, reset for every input,
+    // and copies each one out at its exact size.
+    std::vector<BatchParse> parse_batch(const ParseTable &table, std::span<const std::span<const std::uint32_t>> inputs, std::size_t threads, std::size_t entry)
+    {
+        static constexpr std::size_t chunk = 64;
+
+        std::vector<BatchParse> results(inputs.size());
+        std::atomic<std::size_t> next_input { 0 };
+
+        auto worker = [&]() {
+            LRParser parser { table };
+            ParseTree arena;
+
+            while (true)
+            {
+                auto begin = next_input.fetch_add(chunk, std::memory_order_relaxed);
+
+                if (begin >= inputs.size())
+                {
+                    break;
+                }
+
+                auto end = std::min(begin + chunk, inputs.size());
+
+                for (auto i = begin; i < end; ++i)
+                {
+                    results[i].result = parser.parse(inputs[i], arena, entry);
+                    results[i].tree = arena;
+                }
+            }
+        };
+
+        auto thread_count = threads != 0
+            ? threads
+            : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+        thread_count = std::min(thread_count, (inputs.size() + chunk - 1) / chunk);
+
+        if (thread_count <= 1)
+        {
+            worker();
+            return results;
+        }
+
+        std::vector<std::jthread> workers;
+
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            workers.emplace_back(worker);
+        }
+
+        workers.clear();
+
+        return results;
+    }
+
+    // The same breadth-first search by symbol order as
+    // state_access_paths, run over the rows of the table.
+    std::vector<std::string> table_access_paths(const ParseTable &table)
+    {
+        std::vector<std::size_t> order(table.columns().size());
+
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = i;
+        }
+
+        std::ranges::sort(
+            order,
+            [&](std::size_t a, std::size_t b) {
+                return table.columns()[a]->id() < table.columns()[b]->id();
+            });
+
+        std::vector<std::string> paths(table.rows());
+        std::vector<bool> visited(table.rows(), false);
+        std::deque<std::size_t> queue;
+
+        for (std::size_t entry = 0; entry < table.entries(); ++entry)
+        {
+            paths[entry] = entry_path_prefix(entry);
+            visited[entry] = true;
+            queue.push_back(entry);
+        }
+
+        while (!queue.empty())
+        {
+            auto row = queue.front();
+            queue.pop_front();
+
+            for (std::size_t column : order)
+            {
+                for (const Action &action : table.actions(row, column))
+                {
+                    if ((action.type != ActionType::shift && action.type != ActionType::go) || visited[action.state])
+                    {
+                        continue;
+                    }
+
+                    visited[action.state] = true;
+
+                    paths[action.state] = paths[row];
+
+                    if (!paths[row].empty())
+                    {
+                        paths[action.state].push_back(' ');
+                    }
+
+                    paths[action.state].append(table.columns()[column]->name());
+                    queue.push_back(action.state);
+                }
+            }
+        }
+
+        return paths;
+    }
+
+    Profile table_profile(const ParseTable &table, const TableProfile &hits)
+    {
+        Profile profile;
+        auto paths = table_access_paths(table);
+
+        for (std::size_t row = 0; row < table.rows(); ++row)
+        {
+            if (hits.row_hits[row] != 0)
+            {
+                profile.states[paths[row]] += hits.row_hits[row];
+            }
+        }
+
+        for (std::size_t column = 0; column < table.columns().size(); ++column)
+        {
+            if (hits.column_hits[column] != 0)
+            {
+                profile.symbols[table.columns()[column]->name()] += hits.column_hits[column];
+            }
+        }
+
+        return profile;
+    }
+
+}
@@ -0,0 +1,141 @@
+#ifndef LR1CC_INCLUDE_RUNTIME_HH
+#define LR1CC_INCLUDE_RUNTIME_HH
+
+#include "layout.hh"
+#include "recovery.hh"
+#include "table.hh"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace lr1cc
+{
+
+    struct TableProfile
+    {
+        std::vector<std::uint64_t> row_hits;
+        std::vector<std::uint64_t> column_hits;
+
+        explicit TableProfile(const ParseTable &);
+    };
+
+    struct ParseResult
+    {
+        bool accepted;
+        std::size_t position;
+        std::size_t reductions;
+    };
+
+    // A node of a parse tree. `symbol' is a column of the table; a
+    // terminal node has no production and spans one token. The children
+    // of a node are children[first_child, first_child + child_count) of
+    // its tree.
+    struct TreeNode
+    {
+        std::uint32_t symbol;
+        const Production *production;
+        std::size_t begin;
+        std::size_t length;
+        std::uint32_t first_child;
+        std::uint32_t child_count;
+
+        bool operator==(const TreeNode &) const = default;
+    };
+
+    // Nodes are in the order they were built, so children precede their
+    // parent. The tree has a root only when parsing accepted; the
+    // End-Of-Tokens token is not part of it.
+    struct ParseTree
+    {
+        std::vector<TreeNode> nodes;
+        std::vector<std::uint32_t> children;
+        std::optional<std::uint32_t> root;
+
+        void clear();
+        std::span<const std::uint32_t> children_of(const TreeNode &) const;
+
+        bool operator==(const ParseTree &) const = default;
+    };
+
+    struct BatchParse
+    {
+        ParseResult result;
+        ParseTree tree;
+    };
+
+    enum class RepairType
+    {
+        insertion, deletion, synchronization, none
+    };
+
+    // An error at the token `position' in the row `row'. An insertion
+    // shifts the terminal `symbol' before the token; a deletion skips
+    // the token; a synchronization pops the stack to a row with a goto
+    // on the nonterminal `symbol', skips `skipped' tokens and takes the
+    // goto. An error without a repair ends parsing.
+    struct ParseError
+    {
+        std::size_t position;
+        std::size_t row;
+        RepairType repair;
+        std::uint32_t symbol;
+        std::size_t skipped;
+    };
+
+    // A deterministic LR parser over a table without conflicts; of a
+    // cell with several actions, only the first is taken. Tokens are
+    // column indices of the table, as written by --generate. Parsing
+    // starts in the entry state of the given start symbol. Given a
+    // RecoveryTable, errors are recorded and repaired instead of ending
+    // parsing; given a ParseTree, the tree is built into it.
+    class LRParser
+    {
+
+        const ParseTable &m_table;
+        TableProfile *m_profile;
+        std::vector<std::size_t> m_stack;
+        std::vector<std::uint32_t> m_columns;
+        std::vector<std::uint32_t> m_nodes;
+
+        ParseResult run(std::span<const std::uint32_t>, std::size_t, const RecoveryTable *, std::vector<ParseError> *, ParseTree *);
+        bool recover(std::span<const std::uint32_t>, ParseResult &, bool, const RecoveryTable &, std::vector<ParseError> &);
+
+    public:
+
+        explicit LRParser(const ParseTable &, TableProfile * = nullptr);
+
+        ParseResult parse(std::span<const std::uint32_t>, std::size_t = 0);
+        ParseResult parse(std::span<Symbol *const>, std::size_t = 0);
+        ParseResult parse(std::span<const std::uint32_t>, const RecoveryTable &, std::vector<ParseError> &, std::size_t = 0);
+        ParseResult parse(std::span<const std::uint32_t>, ParseTree &, std::size_t = 0);
+
+    };
+
+    // Parses a batch of token streams on `threads' threads (0 for one
+    // per CPU), each with its own LRParser and tree arena over the
+    // shared table, which is only read. Results and their trees are in
+    // the order of the inputs.
+    std::vector<BatchParse> parse_batch(const ParseTable &, std::span<const std::span<const std::uint32_t>>, std::size_t = 0, std::size_t = 0);
+
+    std::vector<std::string> table_access_paths(const ParseTable &);
+
+    Profile table_profile(const ParseTable &, const TableProfile &);
+
+    inline void ParseTree::clear()
+    {
+        nodes.clear();
+        children.clear();
+        root.reset();
+    }
+
+    inline std::span<const std::uint32_t> ParseTree::children_of(const TreeNode &node) const
+    {
+        return std::span { children }.subspan(node.first_child, node.child_count);
+    }
+
+}
+
+#endif
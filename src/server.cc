@@ -0,0 +1,313 @@
+
+#include "server.hh"
+#include "driver.hh"
+#include "util.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace lr1cc
+{
+
+    static constexpr std::size_t max_frame_size = 64 * 1024 * 1024;
+
+    Server::Server(const Config &conf)
+        : m_conf { conf },
+          m_hits { 0 },
+          m_misses { 0 },
+          m_stopping { false }
+    {
+        m_conf.stats = StatsFormat::none;
+    }
+
+    static std::optional<std::string> read_content(const std::string &path)
+    {
+        std::ifstream in { path, std::ios::binary };
+
+        if (!in)
+        {
+            return std::nullopt;
+        }
+
+        std::ostringstream content;
+        content << in.rdbuf();
+
+        return std::move(content).str();
+    }
+
+    std::shared_ptr<const GrammarEntry> Server::lookup(const std::string &path)
+    {
+        auto content = read_content(path);
+
+        if (!content.has_value())
+        {
+            return nullptr;
+        }
+
+        auto hash = fnv1a_hash(content.value());
+
+        auto is_unchanged = [](const ModuleSource &source) {
+            auto content = read_content(source.path);
+            return content.has_value() && content.value() == source.module->content;
+        };
+
+        {
+            std::shared_lock lock { m_mutex };
+
+            auto iter = m_entries.find(path);
+
+            if (iter != m_entries.end()
+                && iter->second->hash == hash
+                && iter->second->content == content.value()
+                && std::ranges::all_of(iter->second->sources, is_unchanged))
+            {
+                ++m_hits;
+                return iter->second;
+            }
+        }
+
+        ++m_misses;
+
+        auto entry = std::make_shared<GrammarEntry>();
+        entry->hash = hash;
+        entry->content = std::move(content.value());
+
+        std::ostringstream table { std::ios::binary };
+        std::ostringstream diagnostics;
+        std::ostringstream report;
+
+        entry->status = build_grammar(m_conf, path, entry->content, m_modules, entry->sources, table, diagnostics, report);
+        entry->table = std::move(table).str();
+        entry->diagnostics = std::move(diagnostics).str();
+
+        std::unique_lock lock { m_mutex };
+        m_entries.insert_or_assign(path, entry);
+
+        return entry;
+    }
+
+    // A request is `<command> <path>`; a response starts with a status
+    // line (`ok`, `conflict` or `error`) followed by the body.
+    std::string Server::handle(std::string_view request)
+    {
+        auto space = request.find(' ');
+        auto command = request.substr(0, space);
+        auto path = space == std::string_view::npos ? std::string_view { } : request.substr(space + 1);
+
+        if (command == "shutdown")
+        {
+            m_stopping = true;
+            return "ok\n";
+        }
+
+        if (command != "build" && command != "check" && command != "conflicts")
+        {
+            return "error\nerror: unknown request `" + std::string { command } + "'.\n";
+        }
+
+        if (path.empty())
+        {
+            return "error\nerror: no grammar file given.\n";
+        }
+
+        auto entry = lookup(std::string { path });
+
+        if (entry == nullptr)
+        {
+            return "error\nerror: failed to open `" + std::string { path } + "'.\n";
+        }
+
+        switch (entry->status)
+        {
+        case BuildStatus::success:
+            return command == "build" ? "ok\n" + entry->table : "ok\n";
+        case BuildStatus::conflict:
+            return "conflict\n" + entry->diagnostics;
+        case BuildStatus::failure:
+            break;
+        }
+
+        return "error\n" + entry->diagnostics;
+    }
+
+    static bool read_fully(int fd, char *buffer, std::size_t size)
+    {
+        while (size > 0)
+        {
+            auto n = ::read(fd, buffer, size);
+
+            if (n <= 0)
+            {
+                return false;
+            }
+
+            buffer += n;
+            size -= static_cast<std::size_t>(n);
+        }
+
+        return true;
+    }
+
+    // A frame is the decimal length of the payload, a newline and the
+    // payload itself.
+    std::optional<std::string> read_frame(int fd)
+    {
+        std::string header;
+        char c;
+
+        while (true)
+        {
+            if (!read_fully(fd, &c, 1))
+            {
+                return std::nullopt;
+            }
+
+            if (c == '\n')
+            {
+                break;
+            }
+
+            if (header.size() >= 20)
+            {
+                return std::nullopt;
+            }
+
+            header.push_back(c);
+        }
+
+        std::size_t size;
+        auto [ ptr, ec ] = std::from_chars(header.data(), header.data() + header.size(), size);
+
+        if (ec != std::errc {} || ptr != header.data() + header.size() || header.empty() || size > max_frame_size)
+        {
+            return std::nullopt;
+        }
+
+        std::string payload(size, '\0');
+
+        if (!read_fully(fd, payload.data(), size))
+        {
+            return std::nullopt;
+        }
+
+        return payload;
+    }
+
+    bool write_frame(int fd, std::string_view payload)
+    {
+        auto frame = std::to_string(payload.size()) + '\n';
+        frame.append(payload);
+
+        std::string_view rest { frame };
+
+        while (!rest.empty())
+        {
+            auto n = ::send(fd, rest.data(), rest.size(), MSG_NOSIGNAL);
+
+            if (n <= 0)
+            {
+                return false;
+            }
+
+            rest.remove_prefix(static_cast<std::size_t>(n));
+        }
+
+        return true;
+    }
+
+    static void serve_client(int fd, Server &server, int listener)
+    {
+        while (auto request = read_frame(fd))
+        {
+            if (!write_frame(fd, server.handle(request.value())))
+            {
+                break;
+            }
+
+            if (server.is_stopping())
+            {
+                ::shutdown(listener, SHUT_RDWR);
+                break;
+            }
+        }
+
+        ::close(fd);
+    }
+
+    // Every worker accepts on the shared listening socket, so up to
+    // one client per worker is served at a time.
+    void serve(const std::string &path, Server &server, std::size_t threads)
+    {
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw std::runtime_error { "error: socket path `" + path + "' is too long.\n" };
+        }
+
+        std::copy(path.begin(), path.end(), address.sun_path);
+
+        int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (listener < 0)
+        {
+            throw std::runtime_error { "error: failed to create a socket.\n" };
+        }
+
+        ::unlink(path.c_str());
+
+        if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+            || ::listen(listener, SOMAXCONN) != 0)
+        {
+            ::close(listener);
+            throw std::runtime_error { "error: failed to listen on `" + path + "'.\n" };
+        }
+
+        if (threads == 0)
+        {
+            threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        {
+            std::vector<std::jthread> workers;
+
+            for (std::size_t i = 0; i < threads; ++i)
+            {
+                workers.emplace_back([&]() {
+                    while (!server.is_stopping())
+                    {
+                        int fd = ::accept(listener, nullptr, nullptr);
+
+                        if (fd < 0)
+                        {
+                            if (errno == EINTR || errno == ECONNABORTED)
+                            {
+                                continue;
+                            }
+
+                            break;
+                        }
+
+                        serve_client(fd, server, listener);
+                    }
+                });
+            }
+        }
+
+        ::close(listener);
+        ::unlink(path.c_str());
+    }
+
+}
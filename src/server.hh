@@ -0,0 +1,81 @@
+#ifndef LR1CC_INCLUDE_SERVER_HH
+#define LR1CC_INCLUDE_SERVER_HH
+
+#include "cli.hh"
+#include "driver.hh"
+#include "module.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lr1cc
+{
+
+    struct GrammarEntry
+    {
+        std::uint64_t hash;
+        std::string content;
+        BuildStatus status;
+        std::string table;
+        std::string diagnostics;
+        std::vector<ModuleSource> sources;
+    };
+
+    class Server
+    {
+
+        Config m_conf;
+        std::shared_mutex m_mutex;
+        std::unordered_map<std::string, std::shared_ptr<const GrammarEntry>> m_entries;
+        ModuleCache m_modules;
+        std::atomic<std::size_t> m_hits;
+        std::atomic<std::size_t> m_misses;
+        std::atomic<bool> m_stopping;
+
+        std::shared_ptr<const GrammarEntry> lookup(const std::string &);
+
+    public:
+
+        explicit Server(const Config &);
+
+        Server(const Server &) = delete;
+        Server &operator=(const Server &) = delete;
+
+        std::string handle(std::string_view);
+
+        std::size_t hits() const;
+        std::size_t misses() const;
+        bool is_stopping() const;
+
+    };
+
+    std::optional<std::string> read_frame(int);
+    bool write_frame(int, std::string_view);
+
+    void serve(const std::string &, Server &, std::size_t = 0);
+
+    inline std::size_t Server::hits() const
+    {
+        return m_hits.load();
+    }
+
+    inline std::size_t Server::misses() const
+    {
+        return m_misses.load();
+    }
+
+    inline bool Server::is_stopping() const
+    {
+        return m_stopping.load();
+    }
+
+}
+
+#endif
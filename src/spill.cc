@@ -0,0 +1,179 @@
+
+#include "spill.hh"
+#include "util.hh"
+
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+#include <cerrno>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace lr1cc
+{
+
+    StateSetStore::StateSetStore(const std::string &directory, std::size_t memory_limit)
+        : m_fd { -1 },
+          m_memory_limit { memory_limit },
+          m_offsets { 0 },
+          m_slots(1024, std::pair<std::uint64_t, std::uint32_t> { 0, 0 }),
+          m_flushed { 0 },
+          m_reads { 0 }
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+
+        std::string path = directory + "/lr1cc-spill-XXXXXX";
+
+        m_fd = ::mkstemp(path.data());
+
+        if (m_fd < 0)
+        {
+            throw std::runtime_error { "error: failed to create a spill file in `" + directory + "'.\n" };
+        }
+
+        ::unlink(path.c_str());
+    }
+
+    StateSetStore::~StateSetStore()
+    {
+        ::close(m_fd);
+    }
+
+    void StateSetStore::flush()
+    {
+        std::size_t written = 0;
+
+        while (written < m_buffer.size())
+        {
+            auto n = ::pwrite(m_fd, m_buffer.data() + written, m_buffer.size() - written, static_cast<off_t>(m_flushed + written));
+
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (n <= 0)
+            {
+                throw std::runtime_error { "error: failed to write the spill file.\n" };
+            }
+
+            written += static_cast<std::size_t>(n);
+        }
+
+        m_flushed += m_buffer.size();
+        m_buffer.clear();
+    }
+
+    void StateSetStore::grow()
+    {
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> slots(m_slots.size() * 2, std::pair<std::uint64_t, std::uint32_t> { 0, 0 });
+        auto mask = slots.size() - 1;
+
+        for (const auto &slot : m_slots)
+        {
+            if (slot.second == 0)
+            {
+                continue;
+            }
+
+            auto i = slot.first & mask;
+
+            while (slots[i].second != 0)
+            {
+                i = (i + 1) & mask;
+            }
+
+            slots[i] = slot;
+        }
+
+        m_slots = std::move(slots);
+    }
+
+    // Equal hashes are confirmed by reading the string back, so the
+    // result never depends on the hash being free of collisions.
+    std::pair<std::size_t, bool> StateSetStore::intern(std::string_view bytes)
+    {
+        auto hash = fnv1a_hash(bytes);
+        auto mask = m_slots.size() - 1;
+        auto i = hash & mask;
+
+        while (m_slots[i].second != 0)
+        {
+            if (m_slots[i].first == hash)
+            {
+                std::size_t id = m_slots[i].second - 1;
+
+                if (get(id) == bytes)
+                {
+                    return std::pair { id, false };
+                }
+            }
+
+            i = (i + 1) & mask;
+        }
+
+        std::size_t id = size();
+
+        if (id >= std::numeric_limits<std::uint32_t>::max() - 1)
+        {
+            throw std::runtime_error { "error: too many states for the spill file.\n" };
+        }
+
+        m_slots[i] = std::pair { hash, static_cast<std::uint32_t>(id + 1) };
+
+        m_buffer.append(bytes);
+        m_offsets.push_back(m_offsets.back() + bytes.size());
+
+        if (m_buffer.size() >= m_memory_limit)
+        {
+            flush();
+        }
+
+        if ((size() + 1) * 2 > m_slots.size())
+        {
+            grow();
+        }
+
+        return std::pair { id, true };
+    }
+
+    // The view is valid until the next call of intern or get.
+    std::string_view StateSetStore::get(std::size_t id)
+    {
+        auto begin = m_offsets[id];
+        auto length = static_cast<std::size_t>(m_offsets[id + 1] - begin);
+
+        if (begin >= m_flushed)
+        {
+            return std::string_view { m_buffer }.substr(begin - m_flushed, length);
+        }
+
+        m_scratch.resize(length);
+
+        std::size_t read = 0;
+
+        while (read < length)
+        {
+            auto n = ::pread(m_fd, m_scratch.data() + read, length - read, static_cast<off_t>(begin + read));
+
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (n <= 0)
+            {
+                throw std::runtime_error { "error: failed to read the spill file.\n" };
+            }
+
+            read += static_cast<std::size_t>(n);
+        }
+
+        ++m_reads;
+
+        return m_scratch;
+    }
+
+}
@@ -0,0 +1,77 @@
+#ifndef LR1CC_INCLUDE_SPILL_HH
+#define LR1CC_INCLUDE_SPILL_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace lr1cc
+{
+
+    // StateSetStore interns byte strings, the encoded NFA state sets of
+    // an out-of-core construction, in an unlinked temporary file. In
+    // memory it keeps the offset of every string, an open-addressing
+    // table of their hashes and ids, and a write buffer of at most
+    // `memory_limit' bytes. Only the buffer is bounded by the limit;
+    // the offsets and the hash table grow with the number of strings.
+    // Strings are numbered in the order they are interned and laid out
+    // in that order, so reading them by id in order reads the file
+    // sequentially.
+    class StateSetStore
+    {
+
+        int m_fd;
+        std::size_t m_memory_limit;
+        std::vector<std::uint64_t> m_offsets;
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> m_slots;
+        std::string m_buffer;
+        std::uint64_t m_flushed;
+        std::string m_scratch;
+        std::size_t m_reads;
+
+        void flush();
+        void grow();
+
+    public:
+
+        StateSetStore(const std::string &, std::size_t);
+
+        StateSetStore(const StateSetStore &) = delete;
+        StateSetStore(StateSetStore &&) = delete;
+
+        StateSetStore &operator=(const StateSetStore &) = delete;
+        StateSetStore &operator=(StateSetStore &&) = delete;
+
+        ~StateSetStore();
+
+        std::pair<std::size_t, bool> intern(std::string_view);
+
+        std::string_view get(std::size_t);
+
+        std::size_t size() const;
+        std::uint64_t bytes() const;
+        std::size_t reads() const;
+
+    };
+
+    inline std::size_t StateSetStore::size() const
+    {
+        return m_offsets.size() - 1;
+    }
+
+    inline std::uint64_t StateSetStore::bytes() const
+    {
+        return m_offsets.back();
+    }
+
+    inline std::size_t StateSetStore::reads() const
+    {
+        return m_reads;
+    }
+
+}
+
+#endif
@@ -0,0 +1,537 @@
+#ifndef LR1CC_INCLUDE_STATIC_TABLE_HH
+#define LR1CC_INCLUDE_STATIC_TABLE_HH
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lr1cc
+{
+
+    enum class CellType : std::uint8_t
+    {
+        error, shift, reduce, accept
+    };
+
+    // The target row of a shift or the index of the production of a
+    // reduction.
+    struct ActionCell
+    {
+        CellType type;
+        std::uint32_t value;
+    };
+
+    inline constexpr std::uint32_t no_goto = std::numeric_limits<std::uint32_t>::max();
+
+    // `rhs' and the start symbols of a StaticGrammar are separated by
+    // spaces. Symbols on a left-hand side are intermediate symbols and
+    // all others terminals.
+    struct StaticProduction
+    {
+        std::string_view name;
+        std::string_view lhs;
+        std::string_view rhs;
+    };
+
+    struct StaticGrammar
+    {
+        std::string_view start;
+        std::string_view end;
+        std::span<const StaticProduction> productions;
+    };
+
+    struct StaticRule
+    {
+        std::string_view name;
+        std::uint32_t lhs;
+        std::uint32_t length;
+    };
+
+    struct StaticTableShape
+    {
+        std::size_t rows;
+        std::size_t terminals;
+        std::size_t nonterminals;
+        std::size_t productions;
+        std::size_t entries;
+    };
+
+    // A dense table computed at compile time by make_static_table. The
+    // layout is that of TableResult in library.hh: symbols in column
+    // order, terminals first and End-Of-Tokens symbol the first of them,
+    // and row i the entry state of the start symbol starts[i].
+    template <StaticTableShape Shape>
+    struct StaticTable
+    {
+        static constexpr std::size_t rows = Shape.rows;
+        static constexpr std::size_t terminals = Shape.terminals;
+        static constexpr std::size_t nonterminals = Shape.nonterminals;
+
+        std::array<std::string_view, Shape.terminals + Shape.nonterminals> symbols;
+        std::array<StaticRule, Shape.productions> productions;
+        std::array<std::uint32_t, Shape.entries> starts;
+        std::array<ActionCell, Shape.rows * Shape.terminals> actions;
+        std::array<std::uint32_t, Shape.rows * Shape.nonterminals> gotos;
+
+        constexpr const ActionCell &action(std::size_t, std::size_t) const;
+        constexpr std::uint32_t go(std::size_t, std::size_t) const;
+        constexpr std::optional<std::size_t> symbol(std::string_view) const;
+    };
+
+    // Not constexpr: reached during constant evaluation, the call makes
+    // the compiler reject the program and show the message; reached at
+    // run time, it throws.
+    [[noreturn]] inline void static_grammar_error(const char *message)
+    {
+        throw std::runtime_error { std::string { "error: " } + message + ".\n" };
+    }
+
+    namespace static_detail
+    {
+
+        struct Rule
+        {
+            std::uint32_t lhs;
+            std::vector<std::uint32_t> rhs;
+        };
+
+        struct Item
+        {
+            std::uint32_t rule;
+            std::uint32_t position;
+            std::uint32_t lookahead;
+
+            constexpr auto operator<=>(const Item &) const = default;
+        };
+
+        // Rules past the productions of the grammar are those of the
+        // augmented start symbols, one per start symbol.
+        struct Analysis
+        {
+            std::vector<std::string_view> names;
+            std::size_t terminals;
+            std::vector<std::uint32_t> starts;
+            std::vector<Rule> rules;
+            std::vector<std::uint8_t> nullable;
+            std::vector<std::vector<std::uint8_t>> first;
+        };
+
+        struct Automaton
+        {
+            std::vector<std::vector<Item>> states;
+            std::vector<std::uint32_t> transitions;
+            std::vector<ActionCell> actions;
+            std::size_t conflicts;
+        };
+
+        constexpr std::vector<std::string_view> split(std::string_view text)
+        {
+            std::vector<std::string_view> words;
+
+            while (!text.empty())
+            {
+                auto begin = text.find_first_not_of(" \t\n");
+
+                if (begin == std::string_view::npos)
+                {
+                    break;
+                }
+
+                text.remove_prefix(begin);
+
+                auto length = std::min(text.find_first_of(" \t\n"), text.size());
+
+                words.push_back(text.substr(0, length));
+                text.remove_prefix(length);
+            }
+
+            return words;
+        }
+
+        constexpr std::optional<std::uint32_t> find_name(const std::vector<std::string_view> &names, std::string_view name)
+        {
+            auto iter = std::ranges::find(names, name);
+
+            if (iter == names.end())
+            {
+                return std::nullopt;
+            }
+
+            return static_cast<std::uint32_t>(iter - names.begin());
+        }
+
+        // calculate_nullable and calculate_first of grammar.cc, over
+        // symbol indices.
+        constexpr void calculate_first(Analysis &a)
+        {
+            auto symbols = a.names.size() + a.starts.size();
+
+            a.nullable.assign(symbols, 0);
+            a.first.assign(symbols, std::vector<std::uint8_t>(a.terminals, 0));
+
+            for (std::size_t t = 0; t < a.terminals; ++t)
+            {
+                a.first[t][t] = 1;
+            }
+
+            bool updated = true;
+
+            while (updated)
+            {
+                updated = false;
+
+                for (const Rule &r : a.rules)
+                {
+                    bool nullable = true;
+
+                    for (std::uint32_t s : r.rhs)
+                    {
+                        for (std::size_t t = 0; t < a.terminals; ++t)
+                        {
+                            if (a.first[s][t] != 0 && a.first[r.lhs][t] == 0)
+                            {
+                                a.first[r.lhs][t] = 1;
+                                updated = true;
+                            }
+                        }
+
+                        if (a.nullable[s] == 0)
+                        {
+                            nullable = false;
+                            break;
+                        }
+                    }
+
+                    if (nullable && a.nullable[r.lhs] == 0)
+                    {
+                        a.nullable[r.lhs] = 1;
+                        updated = true;
+                    }
+                }
+            }
+        }
+
+        constexpr Analysis analyze(const StaticGrammar &g)
+        {
+            Analysis a;
+            std::vector<std::string_view> nonterminals;
+
+            for (const StaticProduction &p : g.productions)
+            {
+                if (!find_name(nonterminals, p.lhs).has_value())
+                {
+                    nonterminals.push_back(p.lhs);
+                }
+            }
+
+            if (find_name(nonterminals, g.end).has_value())
+            {
+                static_grammar_error("End-Of-Tokens symbol on a left-hand side");
+            }
+
+            a.names.push_back(g.end);
+
+            for (const StaticProduction &p : g.productions)
+            {
+                for (std::string_view s : split(p.rhs))
+                {
+                    if (!find_name(nonterminals, s).has_value() && !find_name(a.names, s).has_value())
+                    {
+                        a.names.push_back(s);
+                    }
+                }
+            }
+
+            a.terminals = a.names.size();
+            a.names.insert(a.names.end(), nonterminals.begin(), nonterminals.end());
+
+            for (std::string_view s : split(g.start))
+            {
+                auto index = find_name(a.names, s);
+
+                if (!index.has_value() || index.value() < a.terminals)
+                {
+                    static_grammar_error("start symbol without productions");
+                }
+
+                a.starts.push_back(index.value());
+            }
+
+            if (a.starts.empty())
+            {
+                static_grammar_error("start symbol is not provided");
+            }
+
+            for (const StaticProduction &p : g.productions)
+            {
+                Rule r { find_name(a.names, p.lhs).value(), { } };
+
+                for (std::string_view s : split(p.rhs))
+                {
+                    r.rhs.push_back(find_name(a.names, s).value());
+                }
+
+                a.rules.push_back(std::move(r));
+            }
+
+            for (std::size_t i = 0; i < a.starts.size(); ++i)
+            {
+                a.rules.push_back(Rule { static_cast<std::uint32_t>(a.names.size() + i), { a.starts[i] } });
+            }
+
+            calculate_first(a);
+
+            return a;
+        }
+
+        // The closure of a kernel: the items of the named states of
+        // nfa.cc that the epsilon transitions reach, one item per
+        // production, position and follow symbol.
+        constexpr std::vector<Item> closure(const Analysis &a, std::vector<Item> items)
+        {
+            std::vector<std::uint8_t> added(a.rules.size() * a.terminals, 0);
+
+            for (std::size_t i = 0; i < items.size(); ++i)
+            {
+                auto item = items[i];
+                const Rule &r = a.rules[item.rule];
+
+                if (item.position == r.rhs.size() || r.rhs[item.position] < a.terminals)
+                {
+                    continue;
+                }
+
+                std::vector<std::uint8_t> follows(a.terminals, 0);
+                bool nullable = true;
+
+                for (std::size_t k = item.position + 1; k < r.rhs.size() && nullable; ++k)
+                {
+                    for (std::size_t t = 0; t < a.terminals; ++t)
+                    {
+                        follows[t] |= a.first[r.rhs[k]][t];
+                    }
+
+                    nullable = a.nullable[r.rhs[k]] != 0;
+                }
+
+                if (nullable)
+                {
+                    follows[item.lookahead] = 1;
+                }
+
+                for (std::size_t q = 0; q < a.rules.size(); ++q)
+                {
+                    if (a.rules[q].lhs != r.rhs[item.position])
+                    {
+                        continue;
+                    }
+
+                    for (std::size_t t = 0; t < a.terminals; ++t)
+                    {
+                        if (follows[t] != 0 && added[q * a.terminals + t] == 0)
+                        {
+                            added[q * a.terminals + t] = 1;
+                            items.push_back(Item { static_cast<std::uint32_t>(q), 0, static_cast<std::uint32_t>(t) });
+                        }
+                    }
+                }
+            }
+
+            std::sort(items.begin(), items.end());
+            items.erase(std::unique(items.begin(), items.end()), items.end());
+
+            return items;
+        }
+
+        // nfa_to_dfa of dfa.cc: states are expanded in the order they
+        // are created, the entry states first, so rows come out in
+        // breadth-first order.
+        constexpr Automaton construct(const Analysis &a)
+        {
+            Automaton m { { }, { }, { }, 0 };
+            auto symbols = a.names.size();
+            auto productions = a.rules.size() - a.starts.size();
+
+            for (std::size_t i = 0; i < a.starts.size(); ++i)
+            {
+                m.states.push_back(closure(a, { Item { static_cast<std::uint32_t>(productions + i), 0, 0 } }));
+            }
+
+            for (std::size_t s = 0; s < m.states.size(); ++s)
+            {
+                m.transitions.resize(m.states.size() * symbols, no_goto);
+
+                for (std::size_t x = 0; x < symbols; ++x)
+                {
+                    std::vector<Item> kernel;
+
+                    for (const Item &item : m.states[s])
+                    {
+                        const Rule &r = a.rules[item.rule];
+
+                        if (item.position < r.rhs.size() && r.rhs[item.position] == x)
+                        {
+                            kernel.push_back(Item { item.rule, item.position + 1, item.lookahead });
+                        }
+                    }
+
+                    if (kernel.empty())
+                    {
+                        continue;
+                    }
+
+                    auto state = closure(a, std::move(kernel));
+                    auto iter = std::ranges::find(m.states, state);
+                    auto to = static_cast<std::uint32_t>(iter - m.states.begin());
+
+                    if (iter == m.states.end())
+                    {
+                        m.states.push_back(std::move(state));
+                        m.transitions.resize(m.states.size() * symbols, no_goto);
+                    }
+
+                    m.transitions[s * symbols + x] = to;
+                }
+            }
+
+            m.actions.assign(m.states.size() * a.terminals, ActionCell { CellType::error, 0 });
+
+            for (std::size_t s = 0; s < m.states.size(); ++s)
+            {
+                std::vector<std::size_t> counts(a.terminals, 0);
+
+                for (std::size_t t = 0; t < a.terminals; ++t)
+                {
+                    auto to = m.transitions[s * symbols + t];
+
+                    if (to != no_goto)
+                    {
+                        m.actions[s * a.terminals + t] = ActionCell { CellType::shift, to };
+                        ++counts[t];
+                    }
+                }
+
+                for (const Item &item : m.states[s])
+                {
+                    if (item.position != a.rules[item.rule].rhs.size())
+                    {
+                        continue;
+                    }
+
+                    auto &cell = m.actions[s * a.terminals + item.lookahead];
+
+                    if (++counts[item.lookahead] == 1)
+                    {
+                        cell = item.rule < productions
+                            ? ActionCell { CellType::reduce, item.rule }
+                            : ActionCell { CellType::accept, 0 };
+                    }
+                }
+
+                m.conflicts += static_cast<std::size_t>(std::ranges::count_if(counts, [](std::size_t count) { return count > 1; }));
+            }
+
+            return m;
+        }
+
+    }
+
+    // The number of cells with more than one action.
+    constexpr std::size_t static_conflicts(const StaticGrammar &g)
+    {
+        return static_detail::construct(static_detail::analyze(g)).conflicts;
+    }
+
+    constexpr StaticTableShape static_table_shape(const StaticGrammar &g)
+    {
+        auto a = static_detail::analyze(g);
+        auto m = static_detail::construct(a);
+
+        return StaticTableShape {
+            m.states.size(),
+            a.terminals,
+            a.names.size() - a.terminals,
+            a.rules.size() - a.starts.size(),
+            a.starts.size()
+        };
+    }
+
+    // Builds the table of the grammar returned by `GrammarFn', usually a
+    // captureless lambda, during compilation; a conflict is a compile
+    // error.
+    template <typename GrammarFn>
+    consteval auto make_static_table(GrammarFn)
+    {
+        constexpr auto shape = static_table_shape(GrammarFn {}());
+
+        auto a = static_detail::analyze(GrammarFn {}());
+        auto m = static_detail::construct(a);
+
+        if (m.conflicts != 0)
+        {
+            static_grammar_error("grammar is not LR(1)");
+        }
+
+        StaticTable<shape> table { };
+        auto symbols = a.names.size();
+
+        std::ranges::copy(a.names, table.symbols.begin());
+        std::ranges::copy(a.starts, table.starts.begin());
+        std::ranges::copy(m.actions, table.actions.begin());
+
+        for (std::size_t i = 0; i < shape.productions; ++i)
+        {
+            table.productions[i] = StaticRule {
+                GrammarFn {}().productions[i].name,
+                a.rules[i].lhs,
+                static_cast<std::uint32_t>(a.rules[i].rhs.size())
+            };
+        }
+
+        for (std::size_t s = 0; s < shape.rows; ++s)
+        {
+            for (std::size_t n = 0; n < shape.nonterminals; ++n)
+            {
+                table.gotos[s * shape.nonterminals + n] = m.transitions[s * symbols + shape.terminals + n];
+            }
+        }
+
+        return table;
+    }
+
+    template <StaticTableShape Shape>
+    constexpr const ActionCell &StaticTable<Shape>::action(std::size_t row, std::size_t terminal) const
+    {
+        return actions[row * terminals + terminal];
+    }
+
+    template <StaticTableShape Shape>
+    constexpr std::uint32_t StaticTable<Shape>::go(std::size_t row, std::size_t nonterminal) const
+    {
+        return gotos[row * nonterminals + nonterminal];
+    }
+
+    template <StaticTableShape Shape>
+    constexpr std::optional<std::size_t> StaticTable<Shape>::symbol(std::string_view name) const
+    {
+        auto iter = std::ranges::find(symbols, name);
+
+        if (iter == symbols.end())
+        {
+            return std::nullopt;
+        }
+
+        return static_cast<std::size_t>(iter - symbols.begin());
+    }
+
+}
+
+#endif
@@ -0,0 +1,256 @@
+
+#include "stats.hh"
+
+#include <fstream>
+#include <iomanip>
+#include <string_view>
+
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace lr1cc
+{
+
+    static double thread_cpu_seconds()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+        return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+    }
+
+    Stopwatch::Stopwatch()
+        : m_wall { std::chrono::steady_clock::now() },
+          m_cpu { thread_cpu_seconds() }
+    {
+    }
+
+    PhaseTiming Stopwatch::lap(std::string_view name)
+    {
+        auto wall = std::chrono::steady_clock::now();
+        auto cpu = thread_cpu_seconds();
+
+        PhaseTiming timing {
+            std::string { name },
+            std::chrono::duration<double> { wall - m_wall }.count(),
+            cpu - m_cpu
+        };
+
+        m_wall = wall;
+        m_cpu = cpu;
+
+        return timing;
+    }
+
+    AutomatonStats nfa_stats(const NFA &nfa)
+    {
+        AutomatonStats stats { 0, 0 };
+
+        for (NFAState *state : nfa.states())
+        {
+            ++stats.states;
+
+            for (const auto &pair : state->transitions())
+            {
+                stats.transitions += pair.second.size();
+            }
+        }
+
+        return stats;
+    }
+
+    AutomatonStats dfa_stats(const DFA &dfa)
+    {
+        AutomatonStats stats { 0, 0 };
+
+        for (DFAState *state : dfa.states())
+        {
+            ++stats.states;
+            stats.transitions += state->transitions().size();
+        }
+
+        return stats;
+    }
+
+    std::size_t peak_rss_kib()
+    {
+        rusage usage;
+
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+
+        return static_cast<std::size_t>(usage.ru_maxrss);
+    }
+
+    std::size_t current_rss_kib()
+    {
+        std::ifstream statm { "/proc/self/statm" };
+        std::size_t size, resident;
+
+        if (!(statm >> size >> resident))
+        {
+            return peak_rss_kib();
+        }
+
+        return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+    }
+
+    static void output_hash_table_stats(std::string_view name, const HashTableStats &stats, std::ostream &out)
+    {
+        out << name << ": "
+            << stats.size << " entries, "
+            << stats.bucket_count << " buckets, load "
+            << std::setprecision(3) << stats.load_factor << ", "
+            << stats.collisions << " collisions\n";
+    }
+
+    void output_stats(const Stats &stats, std::ostream &out)
+    {
+        auto flags = out.flags();
+        auto precision = out.precision();
+
+        out << std::fixed << std::setprecision(6);
+
+        out << std::left << std::setw(12) << "phase"
+            << std::right << std::setw(12) << "wall [s]"
+            << std::setw(12) << "cpu [s]" << '\n';
+
+        for (const PhaseTiming &phase : stats.phases)
+        {
+            out << std::left << std::setw(12) << phase.name
+                << std::right << std::setw(12) << phase.wall_seconds
+                << std::setw(12) << phase.cpu_seconds << '\n';
+        }
+
+        out.flags(flags);
+
+        out << "input: " << stats.input << '\n';
+        out << "construction: " << stats.construction << '\n';
+        out << "nfa: " << stats.nfa.states << " states, " << stats.nfa.transitions << " transitions\n";
+        out << "dfa: " << stats.dfa.states << " states, " << stats.dfa.transitions << " transitions\n";
+
+        output_hash_table_stats("named states", stats.named_states, out);
+        output_hash_table_stats("dfa states", stats.dfa_states, out);
+
+        out.precision(precision);
+
+        out << "table: " << stats.table.rows << " rows, "
+            << stats.table.columns << " columns, "
+            << stats.table.filled_cells << '/' << stats.table.rows * stats.table.columns << " cells filled, "
+            << stats.table.distinct_rows << " distinct rows\n";
+
+        out << "peak rss: " << stats.peak_rss_kib << " KiB\n";
+
+        out << std::flush;
+    }
+
+    // Input names come from the command line or the library caller and
+    // may hold any byte, so strings are always escaped.
+    static void output_json_string(std::string_view string, std::ostream &out)
+    {
+        static constexpr char hex_digits[] = "0123456789abcdef";
+
+        out << '"';
+
+        for (char ch : string)
+        {
+            auto byte = static_cast<unsigned char>(ch);
+
+            if (ch == '"' || ch == '\\')
+            {
+                out << '\\' << ch;
+            }
+            else if (ch == '\n')
+            {
+                out << "\\n";
+            }
+            else if (ch == '\r')
+            {
+                out << "\\r";
+            }
+            else if (ch == '\t')
+            {
+                out << "\\t";
+            }
+            else if (byte < 0x20)
+            {
+                out << "\\u00" << hex_digits[byte >> 4] << hex_digits[byte & 0xf];
+            }
+            else
+            {
+                out << ch;
+            }
+        }
+
+        out << '"';
+    }
+
+    static void output_hash_table_stats_json(const HashTableStats &stats, std::ostream &out)
+    {
+        out << "{\"size\":" << stats.size
+            << ",\"buckets\":" << stats.bucket_count
+            << ",\"load_factor\":" << stats.load_factor
+            << ",\"collisions\":" << stats.collisions
+            << '}';
+    }
+
+    static void output_automaton_stats_json(const AutomatonStats &stats, std::ostream &out)
+    {
+        out << "{\"states\":" << stats.states
+            << ",\"transitions\":" << stats.transitions
+            << '}';
+    }
+
+    void output_stats_json(const Stats &stats, std::ostream &out)
+    {
+        auto precision = out.precision();
+
+        out << std::setprecision(9);
+
+        out << "{\"input\":";
+        output_json_string(stats.input, out);
+
+        out << ",\"construction\":";
+        output_json_string(stats.construction, out);
+
+        out << ",\"phases\":[";
+
+        for (std::size_t i = 0; i < stats.phases.size(); ++i)
+        {
+            const PhaseTiming &phase = stats.phases[i];
+
+            out << (i == 0 ? "" : ",") << "{\"name\":";
+            output_json_string(phase.name, out);
+
+            out << ",\"wall\":" << phase.wall_seconds
+                << ",\"cpu\":" << phase.cpu_seconds
+                << '}';
+        }
+
+        out << "],\"nfa\":";
+        output_automaton_stats_json(stats.nfa, out);
+
+        out << ",\"dfa\":";
+        output_automaton_stats_json(stats.dfa, out);
+
+        out << ",\"hash_tables\":{\"named_states\":";
+        output_hash_table_stats_json(stats.named_states, out);
+
+        out << ",\"dfa_states\":";
+        output_hash_table_stats_json(stats.dfa_states, out);
+
+        out << "},\"table\":{\"rows\":" << stats.table.rows
+            << ",\"columns\":" << stats.table.columns
+            << ",\"filled_cells\":" << stats.table.filled_cells
+            << ",\"distinct_rows\":" << stats.table.distinct_rows
+            << "},\"peak_rss_kib\":" << stats.peak_rss_kib
+            << "}\n";
+
+        out.precision(precision);
+        out << std::flush;
+    }
+
+}
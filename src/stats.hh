@@ -0,0 +1,69 @@
+#ifndef LR1CC_INCLUDE_STATS_HH
+#define LR1CC_INCLUDE_STATS_HH
+
+#include "nfa.hh"
+#include "dfa.hh"
+#include "output.hh"
+#include "util.hh"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lr1cc
+{
+
+    struct PhaseTiming
+    {
+        std::string name;
+        double wall_seconds;
+        double cpu_seconds;
+    };
+
+    class Stopwatch
+    {
+
+        std::chrono::steady_clock::time_point m_wall;
+        double m_cpu;
+
+    public:
+
+        Stopwatch();
+
+        PhaseTiming lap(std::string_view);
+
+    };
+
+    struct AutomatonStats
+    {
+        std::size_t states;
+        std::size_t transitions;
+    };
+
+    struct Stats
+    {
+        std::string input;
+        std::string construction;
+        std::vector<PhaseTiming> phases;
+        AutomatonStats nfa;
+        AutomatonStats dfa;
+        HashTableStats named_states;
+        HashTableStats dfa_states;
+        TableStats table;
+        std::size_t peak_rss_kib;
+    };
+
+    AutomatonStats nfa_stats(const NFA &);
+    AutomatonStats dfa_stats(const DFA &);
+
+    std::size_t peak_rss_kib();
+    std::size_t current_rss_kib();
+
+    void output_stats(const Stats &, std::ostream &);
+    void output_stats_json(const Stats &, std::ostream &);
+
+}
+
+#endif
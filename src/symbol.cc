@@ -7,10 +7,12 @@
 namespace lr1cc
 {
 
-    Symbol::Symbol(std::string_view name, SymbolType type)
+    Symbol::Symbol(std::string_view name, SymbolType type, std::size_t id)
         : m_name { name },
           m_type { type },
-          m_nullable { false }
+          m_id { id },
+          m_nullable { false },
+          m_useless { false }
     {
         if (m_type == SymbolType::terminal)
         {
@@ -29,7 +31,7 @@ namespace lr1cc
             return nullptr;
         }
         
-        auto ptr = std::make_unique<Symbol>(name, type);
+        auto ptr = std::make_unique<Symbol>(name, type, m_symbols.size() + 1);
         auto raw_ptr = ptr.get();
 
         m_symbols.push_back(std::move(ptr));
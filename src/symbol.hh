@@ -24,19 +24,26 @@ namespace lr1cc
 
     class Symbol;
 
-    using First = std::set<Symbol *>;
+    struct SymbolLess
+    {
+        bool operator()(const Symbol *, const Symbol *) const;
+    };
+
+    using First = std::set<Symbol *, SymbolLess>;
     
     class Symbol
     {
 
         std::string m_name;
         SymbolType m_type;
+        std::size_t m_id;
         bool m_nullable;
+        bool m_useless;
         First m_first;
 
     public:
 
-        Symbol(std::string_view, SymbolType);
+        Symbol(std::string_view, SymbolType, std::size_t = 0);
 
         Symbol(const Symbol &) = delete;
         Symbol(Symbol &&) = delete;
@@ -46,12 +53,18 @@ namespace lr1cc
         
         const std::string &name() const;
 
+        std::size_t id() const;
+
         SymbolType type() const;
         bool is_terminal() const;
         bool is_intermediate() const;
 
         bool is_nullable() const;
         void set_nullable();
+        void clear_nullable();
+
+        bool is_useless() const;
+        void set_useless();
 
         const First &first() const;
         First &first();
@@ -64,7 +77,7 @@ namespace lr1cc
 
     template <typename R>
     requires std::ranges::input_range<std::remove_reference_t<R>>
-    std::set<Symbol *> first(R &&, Symbol * = nullptr);
+    First first(R &&, Symbol * = nullptr);
         
     class SymbolManager
     {
@@ -95,6 +108,11 @@ namespace lr1cc
         return m_name;
     }
 
+    inline std::size_t Symbol::id() const
+    {
+        return m_id;
+    }
+
     inline SymbolType Symbol::type() const
     {
         return m_type;
@@ -119,6 +137,21 @@ namespace lr1cc
     {
         m_nullable = true;
     }
+
+    inline void Symbol::clear_nullable()
+    {
+        m_nullable = false;
+    }
+
+    inline bool Symbol::is_useless() const
+    {
+        return m_useless;
+    }
+
+    inline void Symbol::set_useless()
+    {
+        m_useless = true;
+    }
     
     inline const First &Symbol::first() const
     {
@@ -141,9 +174,9 @@ namespace lr1cc
 
     template <typename R>
     requires std::ranges::input_range<std::remove_reference_t<R>>
-    std::set<Symbol *> first(R &&r, Symbol *sentinel)
+    First first(R &&r, Symbol *sentinel)
     {
-        std::set<Symbol *> result;
+        First result;
 
         for (Symbol *s : r)
         {
@@ -163,6 +196,24 @@ namespace lr1cc
         return result;
     }
 
+    // Symbols created by a SymbolManager are ordered by declaration so
+    // that iteration over symbol-keyed containers does not depend on
+    // heap addresses.
+    inline bool SymbolLess::operator()(const Symbol *a, const Symbol *b) const
+    {
+        if (a == nullptr || b == nullptr)
+        {
+            return a == nullptr && b != nullptr;
+        }
+
+        if (a->id() != b->id())
+        {
+            return a->id() < b->id();
+        }
+
+        return std::less<const Symbol *> {}(a, b);
+    }
+
     inline auto SymbolManager::symbols() const
     {
         auto raw_pointer = [](const std::unique_ptr<Symbol> &p) {
@@ -0,0 +1,207 @@
+#include "table.hh"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+namespace lr1cc
+{
+
+    static void push_actions(DFAState *to_state, Symbol *column, const std::unordered_map<DFAState *, std::size_t> &state_to_row, const std::unordered_map<Symbol *, std::size_t> &column_index, std::vector<Action> &actions)
+    {
+        if (is_row_state(to_state))
+        {
+            auto type = column->is_terminal() ? ActionType::shift : ActionType::go;
+            actions.push_back(Action { type, state_to_row.at(to_state), nullptr });
+        }
+
+        if (to_state->accepts())
+        {
+            actions.push_back(Action { ActionType::accept, 0, nullptr });
+        }
+
+        std::vector<const Production *> reductions { to_state->reductions().begin(), to_state->reductions().end() };
+
+        std::ranges::sort(
+            reductions,
+            [](const Production *a, const Production *b) {
+                return a->name < b->name;
+            });
+
+        for (const Production *p : reductions)
+        {
+            actions.push_back(Action { ActionType::reduce, column_index.at(p->lhs), p });
+        }
+    }
+
+    ParseTable::ParseTable(const TableLayout &layout)
+        : m_columns { layout.columns },
+          m_rows { layout.rows.size() },
+          m_entries { layout.entries }
+    {
+        for (std::size_t i = 0; i < m_columns.size(); ++i)
+        {
+            m_column_index.emplace(m_columns[i], i);
+        }
+
+        std::unordered_map<DFAState *, std::size_t> state_to_row;
+
+        for (DFAState *state : layout.rows)
+        {
+            state_to_row.emplace(state, state_to_row.size());
+        }
+
+        m_offsets.reserve(m_rows * m_columns.size() + 1);
+        m_offsets.push_back(0);
+
+        for (DFAState *state : layout.rows)
+        {
+            for (Symbol *column : m_columns)
+            {
+                auto iter = state->transitions().find(column);
+
+                if (iter != state->transitions().end())
+                {
+                    push_actions(iter->second, column, state_to_row, m_column_index, m_actions);
+                }
+
+                m_offsets.push_back(m_actions.size());
+            }
+        }
+    }
+
+    ParseTable::ParseTable(const DFA &dfa, const std::vector<Symbol *> &columns)
+        : ParseTable { bfs_layout(dfa, columns) }
+    {
+    }
+
+    std::optional<std::size_t> ParseTable::go(std::size_t row, std::size_t column) const
+    {
+        for (const Action &action : actions(row, column))
+        {
+            if (action.type == ActionType::go)
+            {
+                return action.state;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<std::size_t> ParseTable::go(std::size_t row, Symbol *column) const
+    {
+        for (const Action &action : actions(row, column))
+        {
+            if (action.type == ActionType::go)
+            {
+                return action.state;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::size_t ParseTable::conflicts() const
+    {
+        std::size_t count = 0;
+
+        for (std::size_t i = 0; i + 1 < m_offsets.size(); ++i)
+        {
+            if (m_offsets[i + 1] - m_offsets[i] > 1)
+            {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    static void output_action(const Action &action, std::ostream &out)
+    {
+        switch (action.type)
+        {
+        case ActionType::shift:
+            out << 'S' << action.state + 1;
+            break;
+        case ActionType::go:
+            out << 'G' << action.state + 1;
+            break;
+        case ActionType::reduce:
+            out << 'R' << action.production->name;
+            break;
+        case ActionType::accept:
+            out << 'A';
+            break;
+        }
+    }
+
+    static void output_cell(std::span<const Action> actions, std::ostream &out)
+    {
+        for (std::size_t i = 0; i < actions.size(); ++i)
+        {
+            if (i > 0)
+            {
+                out << '/';
+            }
+
+            output_action(actions[i], out);
+        }
+    }
+
+    void output_parse_table(const ParseTable &table, std::ostream &out)
+    {
+        for (Symbol *column : table.columns())
+        {
+            out << ',' << column->name();
+        }
+
+        out << "\r\n";
+
+        for (std::size_t row = 0; row < table.rows(); ++row)
+        {
+            out << row + 1;
+
+            for (std::size_t column = 0; column < table.columns().size(); ++column)
+            {
+                out << ',';
+
+                output_cell(table.actions(row, column), out);
+            }
+
+            out << "\r\n";
+        }
+
+        out << std::flush;
+    }
+
+    TableStats parse_table_stats(const ParseTable &table)
+    {
+        TableStats stats { table.rows(), table.columns().size(), 0, 0 };
+        std::unordered_set<std::string> rows;
+
+        for (std::size_t row = 0; row < table.rows(); ++row)
+        {
+            std::ostringstream cells;
+
+            for (std::size_t column = 0; column < table.columns().size(); ++column)
+            {
+                auto actions = table.actions(row, column);
+
+                if (!actions.empty())
+                {
+                    ++stats.filled_cells;
+                }
+
+                output_cell(actions, cells);
+                cells << ',';
+            }
+
+            rows.emplace(cells.str());
+        }
+
+        stats.distinct_rows = rows.size();
+
+        return stats;
+    }
+
+}
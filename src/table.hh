@@ -0,0 +1,117 @@
+#ifndef LR1CC_INCLUDE_TABLE_HH
+#define LR1CC_INCLUDE_TABLE_HH
+
+#include "dfa.hh"
+#include "output.hh"
+
+#include <iostream>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace lr1cc
+{
+
+    enum class ActionType
+    {
+        shift, go, reduce, accept
+    };
+
+    // `state' is the row a shift or go moves to; for a reduction it is
+    // the column of the left-hand side.
+    struct Action
+    {
+        ActionType type;
+        std::size_t state;
+        const Production *production;
+    };
+
+    // A parsing table whose cells may hold more than one action. Rows
+    // are numbered from 0 in the order of the layout, which the CSV
+    // output numbers from 1; rows 0 to entries() - 1 are the entry
+    // states of the start symbols.
+    class ParseTable
+    {
+
+        std::vector<Symbol *> m_columns;
+        std::unordered_map<Symbol *, std::size_t> m_column_index;
+        std::size_t m_rows;
+        std::size_t m_entries;
+        std::vector<std::size_t> m_offsets;
+        std::vector<Action> m_actions;
+
+    public:
+
+        explicit ParseTable(const TableLayout &);
+        ParseTable(const DFA &, const std::vector<Symbol *> &);
+
+        std::size_t rows() const;
+        std::size_t entries() const;
+        const std::vector<Symbol *> &columns() const;
+
+        std::span<const Action> actions(std::size_t, std::size_t) const;
+        std::span<const Action> actions(std::size_t, Symbol *) const;
+
+        std::optional<std::size_t> column(Symbol *) const;
+
+        std::optional<std::size_t> go(std::size_t, std::size_t) const;
+        std::optional<std::size_t> go(std::size_t, Symbol *) const;
+
+        std::size_t conflicts() const;
+
+    };
+
+    void output_parse_table(const ParseTable &, std::ostream &);
+
+    TableStats parse_table_stats(const ParseTable &);
+
+    inline std::size_t ParseTable::rows() const
+    {
+        return m_rows;
+    }
+
+    inline std::size_t ParseTable::entries() const
+    {
+        return m_entries;
+    }
+
+    inline const std::vector<Symbol *> &ParseTable::columns() const
+    {
+        return m_columns;
+    }
+
+    inline std::span<const Action> ParseTable::actions(std::size_t row, std::size_t column) const
+    {
+        auto cell = row * m_columns.size() + column;
+
+        return std::span<const Action> { m_actions.data() + m_offsets[cell], m_actions.data() + m_offsets[cell + 1] };
+    }
+
+    inline std::span<const Action> ParseTable::actions(std::size_t row, Symbol *symbol) const
+    {
+        auto index = column(symbol);
+
+        if (!index.has_value())
+        {
+            return { };
+        }
+
+        return actions(row, index.value());
+    }
+
+    inline std::optional<std::size_t> ParseTable::column(Symbol *symbol) const
+    {
+        auto iter = m_column_index.find(symbol);
+
+        if (iter == m_column_index.end())
+        {
+            return std::nullopt;
+        }
+
+        return iter->second;
+    }
+
+}
+
+#endif
@@ -1,11 +1,16 @@
 #ifndef LR1CC_INCLUDE_UTIL_HH
 #define LR1CC_INCLUDE_UTIL_HH
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory_resource>
 #include <set>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 namespace lr1cc
 {
@@ -31,7 +36,10 @@ namespace lr1cc
     struct SetHash
     {
 
-        std::size_t operator()(const std::set<A> &set) const
+        using is_transparent = void;
+
+        template <typename Set>
+        std::size_t operator()(const Set &set) const
         {
             std::size_t h = 0;
 
@@ -45,6 +53,21 @@ namespace lr1cc
         
     };
 
+    // Compares sets with different allocators, so that a set built in
+    // scratch memory can look up a long-lived one.
+    struct SetEqual
+    {
+
+        using is_transparent = void;
+
+        template <typename SetA, typename SetB>
+        bool operator()(const SetA &a, const SetB &b) const
+        {
+            return a.size() == b.size() && std::ranges::equal(a, b);
+        }
+
+    };
+
     struct HeterogeneousStringHash
     {
         using is_transparent = void;
@@ -60,6 +83,86 @@ namespace lr1cc
         }
         
     };
+
+    inline std::uint64_t fnv1a_hash(std::string_view bytes)
+    {
+        std::uint64_t h = 0xcbf29ce484222325;
+
+        for (char ch : bytes)
+        {
+            h ^= static_cast<unsigned char>(ch);
+            h *= 0x100000001b3;
+        }
+
+        return h;
+    }
+
+    inline void put_varint(std::string &out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+
+        out.push_back(static_cast<char>(value));
+    }
+
+    // Memory for the temporaries of one step of a construction, such as
+    // expanding a DFA state. Allocation only bumps a pointer and reset()
+    // makes the whole buffer available to the next step; objects
+    // allocated in it must be gone by then.
+    class ScratchMemory
+    {
+
+        std::vector<std::byte> m_buffer;
+        std::pmr::monotonic_buffer_resource m_resource;
+
+    public:
+
+        explicit ScratchMemory(std::size_t size = 256 * 1024)
+            : m_buffer(size),
+              m_resource { m_buffer.data(), m_buffer.size() }
+        {
+        }
+
+        std::pmr::memory_resource *resource()
+        {
+            return &m_resource;
+        }
+
+        void reset()
+        {
+            m_resource.release();
+        }
+
+    };
+
+    struct HashTableStats
+    {
+        std::size_t size;
+        std::size_t bucket_count;
+        double load_factor;
+        std::size_t collisions;
+    };
+
+    template <typename Table>
+    HashTableStats hash_table_stats(const Table &table)
+    {
+        std::size_t collisions = 0;
+
+        for (std::size_t i = 0; i < table.bucket_count(); ++i)
+        {
+            auto bucket_size = table.bucket_size(i);
+
+            if (bucket_size > 1)
+            {
+                collisions += bucket_size - 1;
+            }
+        }
+
+        return HashTableStats { table.size(), table.bucket_count(), table.load_factor(), collisions };
+    }
     
 }
 
@@ -4,8 +4,14 @@
 #include "grammar.hh"
 #include "nfa.hh"
 #include "dfa.hh"
+#include "conflict.hh"
+#include "generate.hh"
+#include "input.hh"
+#include "output.hh"
+#include "runtime.hh"
 
 #include <algorithm>
+#include <fstream>
 
 using namespace lr1cc;
 
@@ -350,3 +356,367 @@ TEST(Automate, Recursive)
     EXPECT_TRUE(nfa_result_reduces(nfa.run(std::ranges::views::single(&end)), &p4));
     EXPECT_TRUE(dfa_result_reduces(dfa.run(std::ranges::views::single(&end)), &p4));
 }
+
+TEST(Automata, LALRMerge)
+{
+    // S -> a S c
+    // S -> T
+    // T -> b T c
+    // T ->
+    Symbol s { "S", SymbolType::intermediate };
+    Symbol t { "T", SymbolType::intermediate };
+    Symbol a { "a", SymbolType::terminal };
+    Symbol b { "b", SymbolType::terminal };
+    Symbol c { "c", SymbolType::terminal };
+    Symbol end { "end", SymbolType::terminal };
+
+    Production p1 { "p1", &s, std::vector { &a, &s, &c } };
+    Production p2 { "p2", &s, std::vector { &t } };
+    Production p3 { "p3", &t, std::vector { &b, &t, &c } };
+    Production p4 { "p4", &t, std::vector<Symbol *> { } };
+
+    Grammar g;
+    g.set_start(&s);
+    g.set_end(&end);
+
+    g.productions().push_back(&p1);
+    g.productions().push_back(&p2);
+    g.productions().push_back(&p3);
+    g.productions().push_back(&p4);
+
+    g.calculate();
+
+    NFA nfa = grammar_to_nfa(g);
+    DFA lr1 = nfa_to_dfa(nfa);
+    DFA lalr = nfa_to_lalr_dfa(nfa);
+
+    EXPECT_LT(std::ranges::distance(lalr.states()), std::ranges::distance(lr1.states()));
+
+    std::vector s_end { &s, &end };
+    EXPECT_TRUE(dfa_result_accepts(lalr.run(s_end)));
+
+    std::vector aascc { &a, &a, &s, &c, &c };
+    EXPECT_TRUE(dfa_result_reduces(lalr.run(aascc), &p1));
+
+    std::vector aabtcc { &a, &a, &b, &t, &c, &c };
+    EXPECT_TRUE(dfa_result_reduces(lalr.run(aabtcc), &p3));
+
+    std::vector bbc { &b, &b, &c };
+    EXPECT_TRUE(dfa_result_reduces(lalr.run(bbc), &p4));
+
+    EXPECT_TRUE(dfa_result_reduces(lalr.run(std::ranges::views::single(&end)), &p4));
+}
+
+TEST(Automata, LALRConflict)
+{
+    Symbol s { "S", SymbolType::intermediate };
+    Symbol e { "E", SymbolType::intermediate };
+    Symbol f { "F", SymbolType::intermediate };
+    Symbol a { "a", SymbolType::terminal };
+    Symbol b { "b", SymbolType::terminal };
+    Symbol c { "c", SymbolType::terminal };
+    Symbol d { "d", SymbolType::terminal };
+    Symbol x { "x", SymbolType::terminal };
+    Symbol end { "end", SymbolType::terminal };
+
+    Production p1 { "1", &s, std::vector { &a, &e, &c } };
+    Production p2 { "2", &s, std::vector { &a, &f, &d } };
+    Production p3 { "3", &s, std::vector { &b, &f, &c } };
+    Production p4 { "4", &s, std::vector { &b, &e, &d } };
+    Production p5 { "5", &e, std::vector { &x } };
+    Production p6 { "6", &f, std::vector { &x } };
+
+    Grammar g;
+    g.set_start(&s);
+    g.set_end(&end);
+
+    g.productions().push_back(&p1);
+    g.productions().push_back(&p2);
+    g.productions().push_back(&p3);
+    g.productions().push_back(&p4);
+    g.productions().push_back(&p5);
+    g.productions().push_back(&p6);
+
+    g.calculate();
+
+    NFA nfa = grammar_to_nfa(g);
+    DFA dfa = nfa_to_lalr_dfa(nfa);
+
+    std::vector axc { &a, &x, &c };
+    auto state = dfa.run(axc);
+    ASSERT_NE(nullptr, state);
+    EXPECT_EQ((std::set { &p5, &p6 }), state->reductions());
+}
+
+TEST(Automata, SLR)
+{
+    // S -> a S c
+    // S -> T
+    // T -> b T c
+    // T ->
+    Symbol s { "S", SymbolType::intermediate };
+    Symbol t { "T", SymbolType::intermediate };
+    Symbol a { "a", SymbolType::terminal };
+    Symbol b { "b", SymbolType::terminal };
+    Symbol c { "c", SymbolType::terminal };
+    Symbol end { "end", SymbolType::terminal };
+
+    Production p1 { "p1", &s, std::vector { &a, &s, &c } };
+    Production p2 { "p2", &s, std::vector { &t } };
+    Production p3 { "p3", &t, std::vector { &b, &t, &c } };
+    Production p4 { "p4", &t, std::vector<Symbol *> { } };
+
+    Grammar g;
+    g.set_start(&s);
+    g.set_end(&end);
+
+    g.productions().push_back(&p1);
+    g.productions().push_back(&p2);
+    g.productions().push_back(&p3);
+    g.productions().push_back(&p4);
+
+    g.calculate();
+
+    DFA lr1 = nfa_to_dfa(grammar_to_nfa(g));
+    DFA slr = nfa_to_dfa(grammar_to_slr_nfa(g));
+
+    EXPECT_FALSE(has_conflicts(slr));
+    EXPECT_FALSE(is_lr0(slr));
+    EXPECT_LT(std::ranges::distance(slr.states()), std::ranges::distance(lr1.states()));
+
+    std::vector s_end { &s, &end };
+    EXPECT_TRUE(dfa_result_accepts(slr.run(s_end)));
+
+    std::vector aabtcc { &a, &a, &b, &t, &c, &c };
+    EXPECT_TRUE(dfa_result_reduces(slr.run(aabtcc), &p3));
+
+    std::vector bbc { &b, &b, &c };
+    EXPECT_TRUE(dfa_result_reduces(slr.run(bbc), &p4));
+
+    // S -> a S b
+    // S -> c
+    Production q1 { "q1", &s, std::vector { &a, &s, &b } };
+    Production q2 { "q2", &s, std::vector { &c } };
+
+    Grammar h;
+    h.set_start(&s);
+    h.set_end(&end);
+
+    h.productions().push_back(&q1);
+    h.productions().push_back(&q2);
+
+    h.calculate();
+
+    DFA lr0 = nfa_to_dfa(grammar_to_slr_nfa(h));
+
+    EXPECT_FALSE(has_conflicts(lr0));
+    EXPECT_TRUE(is_lr0(lr0));
+}
+
+TEST(Automata, SLREquivalence)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/lisp.grammar" };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    auto columns = table_columns(manager);
+    DFA slr = nfa_to_dfa(grammar_to_slr_nfa(g));
+
+    ASSERT_FALSE(has_conflicts(slr));
+
+    ParseTable lr1_table { nfa_to_dfa(grammar_to_nfa(g)), columns };
+    ParseTable slr_table { slr, columns };
+
+    EXPECT_LT(slr_table.rows(), lr1_table.rows());
+
+    LRParser lr1_parser { lr1_table };
+    LRParser slr_parser { slr_table };
+
+    std::vector<Symbol *> sentence;
+    SentenceGenerator generator { g, GeneratorOptions { 5000, 12, 5 } };
+
+    generator.generate(
+        [&](Symbol *s) {
+            sentence.push_back(s);
+
+            if (s != g.end())
+            {
+                return;
+            }
+
+            for (std::size_t i = 0; i <= sentence.size(); ++i)
+            {
+                auto broken = sentence;
+
+                if (i < broken.size())
+                {
+                    broken.erase(broken.begin() + i);
+                }
+
+                auto expected = lr1_parser.parse(std::span { broken });
+                auto actual = slr_parser.parse(std::span { broken });
+
+                EXPECT_EQ(expected.accepted, actual.accepted);
+
+                if (expected.accepted)
+                {
+                    EXPECT_EQ(expected.reductions, actual.reductions);
+                }
+            }
+
+            sentence.clear();
+        });
+}
+
+TEST(Automata, SharedFinalStates)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/arithmetic.grammar" };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    DFA dfa = nfa_to_dfa(grammar_to_nfa(g));
+
+    std::set<std::pair<bool, std::set<Production *>>> actions;
+    std::size_t final_states = 0;
+
+    for (DFAState *state : dfa.states())
+    {
+        if (!state->rejects() && state->transitions().empty())
+        {
+            actions.emplace(state->accepts(), state->reductions());
+            ++final_states;
+        }
+    }
+
+    EXPECT_EQ(actions.size(), final_states);
+    EXPECT_EQ(g.productions().size() + 1, final_states);
+}
+
+TEST(Automata, MultipleStarts)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/multi-start.grammar" };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    auto starts = g.starts();
+    auto columns = table_columns(manager);
+
+    ASSERT_EQ(3, starts.size());
+
+    DFA dfa = nfa_to_dfa(grammar_to_nfa(g));
+    ParseTable table { dfa, columns };
+
+    ASSERT_EQ(3, dfa.starts().size());
+    EXPECT_EQ(3, table.entries());
+    EXPECT_EQ(3, nfa_to_lalr_dfa(grammar_to_nfa(g)).starts().size());
+    EXPECT_FALSE(has_conflicts(nfa_to_dfa(grammar_to_slr_nfa(g))));
+
+    LRParser parser { table };
+    std::size_t single_rows = 0;
+
+    std::vector<Symbol *> expression {
+        manager.get_symbol("number"),
+        manager.get_symbol("plus"),
+        manager.get_symbol("ident"),
+        g.end()
+    };
+
+    EXPECT_FALSE(parser.parse(std::span { expression }, 0).accepted);
+    EXPECT_FALSE(parser.parse(std::span { expression }, 1).accepted);
+    EXPECT_TRUE(parser.parse(std::span { expression }, 2).accepted);
+
+    for (std::size_t entry = 0; entry < starts.size(); ++entry)
+    {
+        g.set_start(starts[entry]);
+
+        ParseTable single { nfa_to_dfa(grammar_to_nfa(g)), columns };
+        LRParser single_parser { single };
+
+        single_rows += single.rows();
+
+        std::vector<Symbol *> sentence;
+        SentenceGenerator generator { g, GeneratorOptions { 2000, 12, 7 } };
+
+        generator.generate(
+            [&](Symbol *s) {
+                sentence.push_back(s);
+
+                if (s != g.end())
+                {
+                    return;
+                }
+
+                EXPECT_TRUE(parser.parse(std::span { sentence }, entry).accepted);
+
+                for (std::size_t i = 0; i < sentence.size(); ++i)
+                {
+                    auto broken = sentence;
+                    broken.erase(broken.begin() + i);
+
+                    auto expected = single_parser.parse(std::span { broken });
+                    auto actual = parser.parse(std::span { broken }, entry);
+
+                    EXPECT_EQ(expected.accepted, actual.accepted);
+                    EXPECT_EQ(expected.position, actual.position);
+                    EXPECT_EQ(expected.reductions, actual.reductions);
+                }
+
+                sentence.clear();
+            });
+    }
+
+    EXPECT_LT(table.rows(), single_rows);
+}
+
+TEST(Automata, Budget)
+{
+    Symbol s { "S", SymbolType::intermediate };
+    Symbol a { "a", SymbolType::terminal };
+    Symbol end { "end", SymbolType::terminal };
+
+    Production p1 { "p1", &s, std::vector { &a, &s } };
+    Production p2 { "p2", &s, std::vector { &a } };
+
+    Grammar g;
+    g.set_start(&s);
+    g.set_end(&end);
+
+    g.productions().push_back(&p1);
+    g.productions().push_back(&p2);
+
+    g.calculate();
+
+    NFA nfa = grammar_to_nfa(g);
+
+    Budget budget { Limits { 2, 0, 0 }, "LR(1)" };
+
+    EXPECT_THROW(nfa_to_dfa(nfa, nullptr, &budget), LimitExceeded);
+
+    Budget unlimited { Limits { }, "LR(1)" };
+
+    EXPECT_NO_THROW(nfa_to_dfa(nfa, nullptr, &unlimited));
+
+    // NFA construction checks only the time and memory limits.
+    Budget states_only { Limits { 1, 0, 0 }, "LR(1)" };
+
+    EXPECT_NO_THROW(grammar_to_nfa(g, nullptr, &states_only));
+
+    Budget timeout { Limits { 0, 0, 1e-9 }, "LR(1)" };
+
+    EXPECT_THROW(grammar_to_nfa(g, nullptr, &timeout), LimitExceeded);
+}
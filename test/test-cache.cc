@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "cache.hh"
+#include "input.hh"
+
+#include <filesystem>
+#include <sstream>
+
+using namespace lr1cc;
+
+static std::string canonical_grammar_of(const std::string &text, std::string_view options)
+{
+    std::istringstream in { text };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+
+    return canonical_grammar(g, manager, options);
+}
+
+TEST(Cache, CanonicalGrammar)
+{
+    auto a = canonical_grammar_of(
+        "%start S %end end %terminal x\n"
+        "%grammar S: x [one] | S x [more] ;\n",
+        "");
+
+    auto b = canonical_grammar_of(
+        "# the same grammar, formatted differently\n"
+        "%start S\n"
+        "%end end\n"
+        "%terminal\n"
+        "   x\n"
+        "%grammar\n"
+        "S: x   [one]\n"
+        " | S x [more]\n"
+        " ;\n",
+        "");
+
+    auto c = canonical_grammar_of(
+        "%start S %end end %terminal x\n"
+        "%grammar S: x [one] | x S [more] ;\n",
+        "");
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+
+    auto d = canonical_grammar_of(
+        "%start S %end end %terminal x\n"
+        "%grammar S: x [one] | S x [more] ;\n",
+        "fallback=lalr");
+
+    EXPECT_NE(a, d);
+}
+
+TEST(Cache, StoreAndFind)
+{
+    auto directory = std::filesystem::temp_directory_path() / "lr1cc-test-cache";
+    std::filesystem::remove_all(directory);
+
+    TableCache cache { directory };
+
+    EXPECT_FALSE(cache.find("key-1").has_value());
+
+    cache.store("key-1", ",x\r\n1,S2\r\n");
+    cache.store("key-2", ",y\r\n1,S3\r\n");
+
+    EXPECT_EQ(",x\r\n1,S2\r\n", cache.find("key-1"));
+    EXPECT_EQ(",y\r\n1,S3\r\n", cache.find("key-2"));
+    EXPECT_FALSE(cache.find("key-3").has_value());
+
+    std::filesystem::remove_all(directory);
+}
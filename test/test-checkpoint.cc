@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "checkpoint.hh"
+#include "dfa.hh"
+#include "input.hh"
+#include "output.hh"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace lr1cc;
+
+static std::filesystem::path checkpoint_path(std::string_view name)
+{
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path;
+}
+
+TEST(Checkpoint, SaveAndLoad)
+{
+    auto path = checkpoint_path("lr1cc-test-checkpoint");
+
+    DFACheckpoint checkpoint {
+        300,
+        { { 0, 5, 299 }, { 1 }, { } },
+        { { { 3, 1 }, { 200, 2 } }, { } }
+    };
+
+    Checkpointer checkpointer { path, 42, 0, true };
+
+    EXPECT_TRUE(checkpointer.is_due());
+    EXPECT_FALSE(checkpointer.load().has_value());
+
+    checkpointer.save(checkpoint);
+    EXPECT_EQ(1, checkpointer.saves());
+
+    auto loaded = checkpointer.resume();
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(checkpoint.nfa_states, loaded->nfa_states);
+    EXPECT_EQ(checkpoint.state_sets, loaded->state_sets);
+    EXPECT_EQ(checkpoint.transitions, loaded->transitions);
+
+    Checkpointer fresh { path, 42, 0, false };
+    EXPECT_FALSE(fresh.resume().has_value());
+
+    Checkpointer other { path, 43, 0, true };
+    EXPECT_THROW(other.load(), std::runtime_error);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_THROW(checkpointer.load(), std::runtime_error);
+
+    std::ofstream { path } << "not a checkpoint";
+    EXPECT_THROW(checkpointer.load(), std::runtime_error);
+
+    checkpointer.remove();
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(Checkpoint, Resume)
+{
+    auto path = checkpoint_path("lr1cc-test-checkpoint-resume");
+
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/lisp.grammar" };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    auto nfa = grammar_to_nfa(g);
+    auto columns = table_columns(manager);
+    auto expected = lr1_table_rows(nfa_to_dfa(nfa), columns);
+
+    for (std::size_t max_states : { 1, 2, 5, 10 })
+    {
+        Checkpointer interrupted { path, 1, max_states < 5 ? 3600.0 : 0.0, false };
+        Budget budget { Limits { max_states, 0, 0 }, "LR(1)" };
+
+        EXPECT_THROW(nfa_to_dfa(nfa, nullptr, &budget, &interrupted), LimitExceeded);
+        EXPECT_EQ(max_states < 5, interrupted.saves() == 1);
+
+        Checkpointer resumed { path, 1, 3600, true };
+        auto dfa = nfa_to_dfa(nfa, nullptr, nullptr, &resumed);
+
+        EXPECT_EQ(expected, lr1_table_rows(dfa, columns));
+    }
+
+    std::filesystem::remove(path);
+}
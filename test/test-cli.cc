@@ -13,8 +13,8 @@ TEST(CLI, OK)
     };
     auto conf1 = parse_argv(argv1);
     EXPECT_TRUE(conf1.has_value());
-    EXPECT_EQ("amethyst.y", conf1.value().input_file);
-    EXPECT_EQ("amethyst.y.csv", conf1.value().output_file);
+    EXPECT_EQ("amethyst.y", conf1.value().jobs.at(0).input_file);
+    EXPECT_EQ("amethyst.y.csv", conf1.value().jobs.at(0).output_file);
     EXPECT_FALSE(conf1.value().help);
 
     std::vector<std::string> argv2 {
@@ -25,8 +25,8 @@ TEST(CLI, OK)
     };
     auto conf2 = parse_argv(argv2);
     EXPECT_TRUE(conf2.has_value());
-    EXPECT_EQ("cobra.grammar", conf2.value().input_file);
-    EXPECT_EQ("cobra.csv", conf2.value().output_file);
+    EXPECT_EQ("cobra.grammar", conf2.value().jobs.at(0).input_file);
+    EXPECT_EQ("cobra.csv", conf2.value().jobs.at(0).output_file);
     EXPECT_FALSE(conf2.value().help);
 
     std::vector<std::string> argv3 {
@@ -36,6 +36,180 @@ TEST(CLI, OK)
     auto conf3 = parse_argv(argv3);
     EXPECT_TRUE(conf3.has_value());
     EXPECT_TRUE(conf3.value().help);
+
+    std::vector<std::string> argv4 {
+        "lr1cc",
+        "--stats",
+        "dragon.grammar"
+    };
+    auto conf4 = parse_argv(argv4);
+    EXPECT_TRUE(conf4.has_value());
+    EXPECT_EQ(StatsFormat::text, conf4.value().stats);
+
+    std::vector<std::string> argv5 {
+        "lr1cc",
+        "--stats=json",
+        "-o",
+        "tiger.csv",
+        "tiger.grammar"
+    };
+    auto conf5 = parse_argv(argv5);
+    EXPECT_TRUE(conf5.has_value());
+    EXPECT_EQ(StatsFormat::json, conf5.value().stats);
+    EXPECT_EQ("tiger.csv", conf5.value().jobs.at(0).output_file);
+    EXPECT_EQ(StatsFormat::none, conf1.value().stats);
+
+    std::vector<std::string> argv6 {
+        "lr1cc",
+        "--max-states=1000",
+        "--max-memory=2G",
+        "--timeout=1.5",
+        "--fallback=lalr",
+        "--elide-unit",
+        "wyvern.grammar"
+    };
+    auto conf6 = parse_argv(argv6);
+    EXPECT_TRUE(conf6.has_value());
+    EXPECT_EQ(1000, conf6.value().limits.max_states);
+    EXPECT_EQ(2 * 1024 * 1024, conf6.value().limits.max_memory_kib);
+    EXPECT_DOUBLE_EQ(1.5, conf6.value().limits.timeout_seconds);
+    EXPECT_TRUE(conf6.value().fallback_lalr);
+    EXPECT_TRUE(conf6.value().elide_unit);
+    EXPECT_FALSE(conf1.value().fallback_lalr);
+    EXPECT_FALSE(conf1.value().elide_unit);
+
+    std::vector<std::string> argv7 {
+        "lr1cc",
+        "-j",
+        "4",
+        "greed.y",
+        "sloth.y"
+    };
+    auto conf7 = parse_argv(argv7);
+    EXPECT_TRUE(conf7.has_value());
+    EXPECT_EQ(4, conf7.value().threads);
+    ASSERT_EQ(2, conf7.value().jobs.size());
+    EXPECT_EQ("greed.y", conf7.value().jobs.at(0).input_file);
+    EXPECT_EQ("greed.y.csv", conf7.value().jobs.at(0).output_file);
+    EXPECT_EQ("sloth.y", conf7.value().jobs.at(1).input_file);
+    EXPECT_EQ("sloth.y.csv", conf7.value().jobs.at(1).output_file);
+    EXPECT_EQ(0, conf1.value().threads);
+
+    std::vector<std::string> argv8 {
+        "lr1cc",
+        "--manifest=grammars.txt"
+    };
+    auto conf8 = parse_argv(argv8);
+    EXPECT_TRUE(conf8.has_value());
+    EXPECT_EQ("grammars.txt", conf8.value().manifest_file);
+    EXPECT_TRUE(conf8.value().jobs.empty());
+
+    std::vector<std::string> argv9 {
+        "lr1cc",
+        "--serve",
+        "/tmp/lr1cc.sock"
+    };
+    auto conf9 = parse_argv(argv9);
+    EXPECT_TRUE(conf9.has_value());
+    EXPECT_EQ("/tmp/lr1cc.sock", conf9.value().serve_socket);
+    EXPECT_TRUE(conf9.value().jobs.empty());
+    EXPECT_EQ("", conf1.value().serve_socket);
+
+    std::vector<std::string> argv10 {
+        "lr1cc",
+        "--glr",
+        "basilisk.grammar"
+    };
+    auto conf10 = parse_argv(argv10);
+    EXPECT_TRUE(conf10.has_value());
+    EXPECT_TRUE(conf10.value().glr);
+    EXPECT_FALSE(conf1.value().glr);
+
+    std::vector<std::string> argv11 {
+        "lr1cc",
+        "--generate=100000000",
+        "--seed=7",
+        "--max-depth=32",
+        "--coverage",
+        "chimera.grammar"
+    };
+    auto conf11 = parse_argv(argv11);
+    EXPECT_TRUE(conf11.has_value());
+    EXPECT_EQ(100000000, conf11.value().generator.tokens);
+    EXPECT_EQ(7, conf11.value().generator.seed);
+    EXPECT_EQ(32, conf11.value().generator.max_depth);
+    EXPECT_TRUE(conf11.value().generator.coverage);
+    EXPECT_EQ("chimera.grammar.tokens", conf11.value().jobs.at(0).output_file);
+    EXPECT_EQ(0, conf1.value().generator.tokens);
+
+    std::vector<std::string> argv12 {
+        "lr1cc",
+        "--layout=dfs",
+        "manticore.grammar"
+    };
+    auto conf12 = parse_argv(argv12);
+    EXPECT_TRUE(conf12.has_value());
+    EXPECT_EQ(LayoutType::dfs, conf12.value().layout);
+    EXPECT_EQ(LayoutType::bfs, conf1.value().layout);
+
+    std::vector<std::string> argv13 {
+        "lr1cc",
+        "--profile=hot.profile",
+        "manticore.grammar"
+    };
+    auto conf13 = parse_argv(argv13);
+    EXPECT_TRUE(conf13.has_value());
+    EXPECT_EQ(LayoutType::profile, conf13.value().layout);
+    EXPECT_EQ("hot.profile", conf13.value().profile_file);
+
+    std::vector<std::string> argv14 {
+        "lr1cc",
+        "--checkpoint=hydra.ckpt",
+        "--checkpoint-interval=60",
+        "--resume",
+        "hydra.grammar"
+    };
+    auto conf14 = parse_argv(argv14);
+    EXPECT_TRUE(conf14.has_value());
+    EXPECT_EQ("hydra.ckpt", conf14.value().checkpoint_file);
+    EXPECT_DOUBLE_EQ(60, conf14.value().checkpoint_interval);
+    EXPECT_TRUE(conf14.value().resume);
+    EXPECT_FALSE(conf1.value().resume);
+    EXPECT_EQ(table_options(conf1.value()), table_options(conf14.value()));
+
+    std::vector<std::string> argv15 {
+        "lr1cc",
+        "--construction=auto",
+        "kraken.grammar"
+    };
+    auto conf15 = parse_argv(argv15);
+    EXPECT_TRUE(conf15.has_value());
+    EXPECT_EQ(ConstructionType::automatic, conf15.value().construction);
+    EXPECT_EQ(ConstructionType::lr1, conf1.value().construction);
+    EXPECT_NE(table_options(conf1.value()), table_options(conf15.value()));
+
+    std::vector<std::string> argv16 {
+        "lr1cc",
+        "--spill-dir=/var/tmp",
+        "--spill-memory=16M",
+        "leviathan.grammar"
+    };
+    auto conf16 = parse_argv(argv16);
+    EXPECT_TRUE(conf16.has_value());
+    EXPECT_EQ("/var/tmp", conf16.value().spill_dir);
+    EXPECT_EQ(16 * 1024, conf16.value().spill_memory_kib);
+    EXPECT_EQ("", conf1.value().spill_dir);
+    EXPECT_EQ(table_options(conf1.value()), table_options(conf16.value()));
+
+    std::vector<std::string> argv17 {
+        "lr1cc",
+        "--recovery=basilisk.recovery.csv",
+        "basilisk.grammar"
+    };
+    auto conf17 = parse_argv(argv17);
+    EXPECT_TRUE(conf17.has_value());
+    EXPECT_EQ("basilisk.recovery.csv", conf17.value().recovery_file);
+    EXPECT_EQ(table_options(conf1.value()), table_options(conf17.value()));
 }
 
 TEST(CLI, NG)
@@ -57,9 +231,110 @@ TEST(CLI, NG)
     
     std::vector<std::string> argv3 {
         "lr1cc",
+        "-o",
+        "deadly-sins.csv",
         "greed.y",
         "sloth.y"
     };
     auto conf3 = parse_argv(argv3);
-    EXPECT_FALSE(conf2.has_value());
+    EXPECT_FALSE(conf3.has_value());
+
+    std::vector<std::string> argv4 {
+        "lr1cc",
+        "--max-states=many",
+        "pride.y"
+    };
+    auto conf4 = parse_argv(argv4);
+    EXPECT_FALSE(conf4.has_value());
+
+    std::vector<std::string> argv5 {
+        "lr1cc",
+        "-j",
+        "0",
+        "envy.y"
+    };
+    auto conf5 = parse_argv(argv5);
+    EXPECT_FALSE(conf5.has_value());
+
+    std::vector<std::string> argv6 {
+        "lr1cc"
+    };
+    auto conf6 = parse_argv(argv6);
+    EXPECT_FALSE(conf6.has_value());
+
+    std::vector<std::string> argv7 {
+        "lr1cc",
+        "--serve=/tmp/lr1cc.sock",
+        "wrath.y"
+    };
+    auto conf7 = parse_argv(argv7);
+    EXPECT_FALSE(conf7.has_value());
+
+    std::vector<std::string> argv8 {
+        "lr1cc",
+        "--glr",
+        "--elide-unit",
+        "lust.y"
+    };
+    auto conf8 = parse_argv(argv8);
+    EXPECT_FALSE(conf8.has_value());
+
+    std::vector<std::string> argv9 {
+        "lr1cc",
+        "--generate=0",
+        "vanity.y"
+    };
+    auto conf9 = parse_argv(argv9);
+    EXPECT_FALSE(conf9.has_value());
+
+    std::vector<std::string> argv10 {
+        "lr1cc",
+        "--layout=random",
+        "greed.y"
+    };
+    auto conf10 = parse_argv(argv10);
+    EXPECT_FALSE(conf10.has_value());
+
+    std::vector<std::string> argv11 {
+        "lr1cc",
+        "--resume",
+        "gluttony.y"
+    };
+    auto conf11 = parse_argv(argv11);
+    EXPECT_FALSE(conf11.has_value());
+
+    std::vector<std::string> argv12 {
+        "lr1cc",
+        "--checkpoint=sins.ckpt",
+        "greed.y",
+        "sloth.y"
+    };
+    auto conf12 = parse_argv(argv12);
+    EXPECT_FALSE(conf12.has_value());
+
+    std::vector<std::string> argv13 {
+        "lr1cc",
+        "--construction=lalr",
+        "pride.y"
+    };
+    auto conf13 = parse_argv(argv13);
+    EXPECT_FALSE(conf13.has_value());
+
+    std::vector<std::string> argv14 {
+        "lr1cc",
+        "--spill-dir=/var/tmp",
+        "--checkpoint=sloth.ckpt",
+        "sloth.y"
+    };
+    auto conf14 = parse_argv(argv14);
+    EXPECT_FALSE(conf14.has_value());
+
+    std::vector<std::string> argv15 {
+        "lr1cc",
+        "--recovery=wrath.csv",
+        "--cache-dir=/var/tmp",
+        "wrath.y"
+    };
+    auto conf15 = parse_argv(argv15);
+    EXPECT_FALSE(conf15.has_value());
 }
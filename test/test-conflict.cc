@@ -2,6 +2,11 @@
 #include <gtest/gtest.h>
 
 #include "conflict.hh"
+#include "driver.hh"
+#include "input.hh"
+#include "nfa.hh"
+
+#include <sstream>
 
 using namespace lr1cc;
 
@@ -77,3 +82,44 @@ TEST(Conflict, ShiftReduce)
     EXPECT_EQ(std::vector<Symbol *> { }, conflicts.at(0).start_to_first);
     EXPECT_EQ((std::vector { &x, &y }), conflicts.at(0).first_to_second);
 }
+
+// A reduction is one DFA state whatever its lookahead, so a shift/reduce
+// conflict reports each reduction reachable from the conflict state once,
+// on the first lookahead found, not once per lookahead.
+TEST(Conflict, SharedReductionReport)
+{
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(
+        "%start E\n"
+        "%end end\n"
+        "%terminal num plus\n"
+        "%grammar\n"
+        "E: E plus E [add] | num [num] ;\n",
+        manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    auto nfa = grammar_to_nfa(g);
+    auto dfa = nfa_to_dfa(nfa);
+    auto conflicts = collect_conflicts(dfa);
+
+    std::ostringstream report;
+    report_conflicts(conflicts, g, report);
+
+    EXPECT_EQ(
+        "E plus E [1] plus E [2] end\n"
+        "[1]: add\n"
+        "[2]: add\n"
+        "\n"
+        "E plus E [1] plus num [2] end\n"
+        "[1]: add\n"
+        "[2]: num\n"
+        "\n"
+        "E plus E [1] plus num [2] plus\n"
+        "[1]: add\n"
+        "[2]: num\n"
+        "\n",
+        report.str());
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include "driver.hh"
+#include "library.hh"
+#include "runtime.hh"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace lr1cc;
+
+static std::string read_file(const std::filesystem::path &path)
+{
+    std::ifstream in { path, std::ios::binary };
+    std::ostringstream content;
+
+    content << in.rdbuf();
+
+    return content.str();
+}
+
+static std::vector<Job> sample_jobs(const std::filesystem::path &directory, std::string_view suffix)
+{
+    std::vector<Job> jobs;
+
+    for (auto name : { "arithmetic", "lisp", "non-lalr", "rr-conflict", "sr-conflict" })
+    {
+        auto input = std::filesystem::path { LR1CC_SAMPLE_DIR } / (std::string { name } + ".grammar");
+        auto output = directory / (std::string { name } + std::string { suffix } + ".csv");
+
+        jobs.push_back(Job { input.string(), output.string() });
+    }
+
+    return jobs;
+}
+
+TEST(Driver, BuildAll)
+{
+    auto directory = std::filesystem::temp_directory_path() / "lr1cc-test-driver";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    Config conf { { }, false };
+
+    auto sequential_jobs = sample_jobs(directory, "-sequential");
+    std::vector<int> sequential_status;
+    std::vector<std::string> sequential_diagnostics;
+
+    for (const Job &job : sequential_jobs)
+    {
+        std::ostringstream diagnostics, report;
+
+        sequential_status.push_back(build(conf, job, diagnostics, report));
+        sequential_diagnostics.push_back(diagnostics.str());
+    }
+
+    EXPECT_EQ((std::vector { 0, 0, 0, 1, 1 }), sequential_status);
+    EXPECT_TRUE(sequential_diagnostics[0].empty());
+    EXPECT_NE(std::string::npos, sequential_diagnostics[3].find("1 conflict detected."));
+    EXPECT_NE(std::string::npos, sequential_diagnostics[4].find("1 conflict detected."));
+
+    conf.threads = 3;
+
+    auto concurrent_jobs = sample_jobs(directory, "-concurrent");
+    std::ostringstream diagnostics, report;
+
+    EXPECT_EQ(1, build_all(conf, concurrent_jobs, diagnostics, report));
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(read_file(sequential_jobs[i].output_file), read_file(concurrent_jobs[i].output_file));
+    }
+
+    auto rr = diagnostics.str().find(concurrent_jobs[3].input_file + ":\n");
+    auto sr = diagnostics.str().find(concurrent_jobs[4].input_file + ":\n");
+
+    ASSERT_NE(std::string::npos, rr);
+    ASSERT_NE(std::string::npos, sr);
+    EXPECT_LT(rr, sr);
+    EXPECT_EQ(std::string::npos, diagnostics.str().find(concurrent_jobs[0].input_file + ":\n"));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(Driver, MissingInput)
+{
+    Config conf { { }, false };
+    std::ostringstream diagnostics, report;
+
+    EXPECT_EQ(1, build(conf, Job { "/nonexistent/greed.grammar", "/nonexistent/greed.csv" }, diagnostics, report));
+    EXPECT_EQ("error: failed to open `/nonexistent/greed.grammar'.\n", diagnostics.str());
+}
+
+TEST(Driver, GenerateLayout)
+{
+    auto directory = std::filesystem::temp_directory_path() / "lr1cc-test-driver-generate";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    auto input = std::filesystem::path { LR1CC_SAMPLE_DIR } / "arithmetic.grammar";
+    auto output = directory / "arithmetic.tokens";
+
+    Config conf { { }, false };
+    conf.layout = LayoutType::dfs;
+    conf.generator.tokens = 2000;
+    conf.generator.max_depth = 8;
+    conf.generator.seed = 7;
+
+    std::ostringstream diagnostics;
+
+    ASSERT_EQ(0, generate(conf, Job { input.string(), output.string() }, diagnostics)) << diagnostics.str();
+
+    auto stream = read_file(output);
+    std::vector<std::uint32_t> tokens(stream.size() / 4);
+    std::memcpy(tokens.data(), stream.data(), tokens.size() * 4);
+
+    ASSERT_FALSE(tokens.empty());
+
+    BuildOptions options;
+    options.layout = LayoutType::dfs;
+
+    auto result = build_table(read_file(input), options);
+
+    ASSERT_EQ(BuildStatus::success, result.status) << result.diagnostics;
+
+    auto end = tokens.back();
+
+    EXPECT_EQ("end", result.symbols[end].name);
+    EXPECT_NE(0, end);
+
+    LRParser parser { result.table.value() };
+    std::size_t begin = 0;
+    std::size_t sentences = 0;
+
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+    {
+        if (tokens[i] == end)
+        {
+            EXPECT_TRUE(parser.parse(std::span { tokens }.subspan(begin, i + 1 - begin)).accepted);
+            begin = i + 1;
+            ++sentences;
+        }
+    }
+
+    EXPECT_LT(1, sentences);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(Driver, AutomaticConstructionNotes)
+{
+    auto directory = std::filesystem::temp_directory_path() / "lr1cc-test-driver-auto";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    auto input = std::filesystem::path { LR1CC_SAMPLE_DIR } / "arithmetic.grammar";
+
+    Config conf { { }, false };
+    conf.construction = ConstructionType::automatic;
+    conf.checkpoint_file = (directory / "arithmetic.checkpoint").string();
+
+    std::ostringstream diagnostics, report;
+
+    EXPECT_EQ(0, build(conf, Job { input.string(), (directory / "arithmetic.csv").string() }, diagnostics, report));
+    EXPECT_NE(std::string::npos, diagnostics.str().find("using SLR(1) construction.\n"));
+    EXPECT_NE(std::string::npos, diagnostics.str().find("note: --checkpoint and --resume are ignored by SLR(1) construction.\n"));
+    EXPECT_FALSE(std::filesystem::exists(conf.checkpoint_file));
+
+    conf.checkpoint_file.clear();
+    conf.spill_dir = (directory / "spill").string();
+
+    diagnostics.str("");
+
+    EXPECT_EQ(0, build(conf, Job { input.string(), (directory / "arithmetic.csv").string() }, diagnostics, report));
+    EXPECT_NE(std::string::npos, diagnostics.str().find("note: --spill-dir is ignored by SLR(1) construction.\n"));
+    EXPECT_EQ(std::string::npos, diagnostics.str().find("--checkpoint"));
+
+    std::filesystem::remove_all(directory);
+}
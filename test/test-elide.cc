@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include "elide.hh"
+#include "input.hh"
+#include "output.hh"
+
+#include <sstream>
+
+using namespace lr1cc;
+
+static const char *const cascade =
+    "%start Sum %end end\n"
+    "%terminal num plus mul sparen eparen\n"
+    "%intermediate Product Atom\n"
+    "%grammar\n"
+    "Sum: Sum plus Product [add] | Product [] ;\n"
+    "Product: Product mul Atom [mul] | Atom [] ;\n"
+    "Atom: num [num] | sparen Sum eparen [paren] ;\n";
+
+struct Parse
+{
+    bool accepted;
+    std::size_t position;
+    std::vector<std::string> reductions;
+};
+
+static Parse run_parser(const DFA &dfa, const std::vector<Symbol *> &input)
+{
+    std::vector<DFAState *> stack { dfa.start() };
+    Parse parse { false, 0, { } };
+
+    while (true)
+    {
+        auto iter = stack.back()->transitions().find(input[parse.position]);
+
+        if (iter == stack.back()->transitions().end())
+        {
+            return parse;
+        }
+
+        auto to_state = iter->second;
+
+        if (to_state->accepts())
+        {
+            parse.accepted = true;
+            return parse;
+        }
+        else if (!to_state->reductions().empty())
+        {
+            auto p = *to_state->reductions().begin();
+
+            if (!p->name.empty())
+            {
+                parse.reductions.push_back(p->name);
+            }
+
+            stack.resize(stack.size() - p->rhs.size());
+            stack.push_back(stack.back()->transitions().at(p->lhs));
+        }
+        else
+        {
+            stack.push_back(to_state);
+            ++parse.position;
+        }
+    }
+}
+
+TEST(Elide, Cascade)
+{
+    std::istringstream in { cascade };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    auto nfa = grammar_to_nfa(g);
+    auto plain = nfa_to_dfa(nfa);
+    auto elided = nfa_to_dfa(nfa);
+
+    EXPECT_THROW(ensure_no_unnamed_reductions(plain), std::runtime_error);
+
+    EXPECT_LT(0, elide_unit_reductions(elided));
+    EXPECT_NO_THROW(ensure_no_unnamed_reductions(elided));
+
+    auto columns = table_columns(manager);
+    EXPECT_GE(lr1_table_rows(plain, columns).size(), lr1_table_rows(elided, columns).size());
+
+    auto s = [&](std::string_view name) {
+        return manager.get_symbol(name);
+    };
+
+    std::vector<std::vector<Symbol *>> inputs {
+        { s("num"), s("end") },
+        { s("num"), s("plus"), s("num"), s("mul"), s("num"), s("end") },
+        { s("sparen"), s("num"), s("plus"), s("num"), s("eparen"), s("mul"), s("num"), s("end") },
+        { s("num"), s("plus"), s("end") },
+        { s("num"), s("num"), s("end") },
+        { s("sparen"), s("num"), s("end") },
+        { s("mul"), s("end") }
+    };
+
+    for (const auto &input : inputs)
+    {
+        auto expected = run_parser(plain, input);
+        auto actual = run_parser(elided, input);
+
+        EXPECT_EQ(expected.accepted, actual.accepted);
+        EXPECT_EQ(expected.position, actual.position);
+        EXPECT_EQ(expected.reductions, actual.reductions);
+    }
+
+    EXPECT_EQ((std::vector<std::string> { "num", "num", "num", "mul", "add" }),
+              run_parser(elided, inputs[1]).reductions);
+}
+
+TEST(Elide, NotUnit)
+{
+    std::istringstream in {
+        "%start S %end end %terminal x\n"
+        "%grammar S: x [] ;\n"
+    };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+
+    EXPECT_THROW(g.ensure_sanity(), std::runtime_error);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "generate.hh"
+#include "glr.hh"
+#include "input.hh"
+
+#include <fstream>
+#include <sstream>
+
+using namespace lr1cc;
+
+class GenerateTest : public ::testing::Test
+{
+
+protected:
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+    std::optional<Grammar> grammar;
+
+    void SetUp() override
+    {
+        std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/arithmetic.grammar" };
+
+        grammar.emplace(parse_input(in, manager, productions));
+        grammar->calculate();
+        grammar->ensure_sanity();
+    }
+
+    std::vector<std::vector<Symbol *>> sentences(const GeneratorOptions &options)
+    {
+        SentenceGenerator generator { grammar.value(), options };
+        std::vector<std::vector<Symbol *>> result { { } };
+
+        auto count = generator.generate(
+            [&](Symbol *s) {
+                result.back().push_back(s);
+
+                if (s == grammar->end())
+                {
+                    result.emplace_back();
+                }
+            });
+
+        result.pop_back();
+
+        EXPECT_LE(options.tokens, count);
+
+        return result;
+    }
+
+};
+
+TEST_F(GenerateTest, MinLength)
+{
+    SentenceGenerator generator { grammar.value(), GeneratorOptions { 1 } };
+
+    EXPECT_EQ(1, generator.min_length(manager.get_symbol("AddExpr")));
+    EXPECT_EQ(1, generator.min_length(manager.get_symbol("PrimaryExpr")));
+    EXPECT_EQ(1, generator.min_height(manager.get_symbol("PrimaryExpr")));
+    EXPECT_EQ(4, generator.min_height(manager.get_symbol("AddExpr")));
+}
+
+TEST_F(GenerateTest, Sentences)
+{
+    ParseTable table { nfa_to_dfa(grammar_to_nfa(grammar.value())), table_columns(manager) };
+
+    auto generated = sentences(GeneratorOptions { 5000, 16, 42 });
+    std::size_t count = 0;
+
+    for (const auto &sentence : generated)
+    {
+        EXPECT_TRUE(glr_parse(table, sentence).accepted);
+        count += sentence.size();
+    }
+
+    EXPECT_LE(5000, count);
+    EXPECT_GT(5000 + 16, count);
+
+    EXPECT_EQ(generated, sentences(GeneratorOptions { 5000, 16, 42 }));
+    EXPECT_NE(generated, sentences(GeneratorOptions { 5000, 16, 43 }));
+
+    for (const auto &sentence : sentences(GeneratorOptions { 100, 0, 42 }))
+    {
+        EXPECT_EQ(2, sentence.size());
+    }
+}
+
+TEST_F(GenerateTest, Coverage)
+{
+    SentenceGenerator generator { grammar.value(), GeneratorOptions { 200, 64, 1, true } };
+
+    generator.generate([](Symbol *) { });
+
+    for (Production *p : grammar->productions())
+    {
+        EXPECT_LT(0, generator.uses(p)) << p->name;
+    }
+}
+
+TEST_F(GenerateTest, TokenStream)
+{
+    SentenceGenerator generator { grammar.value(), GeneratorOptions { 1000 } };
+    std::ostringstream out { std::ios::binary };
+
+    auto count = write_token_stream(generator, table_columns(manager), out);
+
+    ASSERT_EQ(count * 4, out.view().size());
+
+    auto last = out.view().substr(out.view().size() - 4);
+    EXPECT_EQ(std::string_view("\0\0\0\0", 4), last);
+    EXPECT_NE(0, static_cast<unsigned char>(out.view()[0]));
+}
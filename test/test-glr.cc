@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include "glr.hh"
+#include "conflict.hh"
+#include "input.hh"
+
+#include <fstream>
+#include <sstream>
+
+using namespace lr1cc;
+
+struct GLRGrammar
+{
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+    DFA dfa;
+
+    explicit GLRGrammar(const char *text)
+    {
+        std::istringstream in { text };
+
+        auto g = parse_input(in, manager, productions);
+        g.calculate();
+        g.ensure_sanity();
+
+        dfa = nfa_to_dfa(grammar_to_nfa(g));
+    }
+
+    std::vector<Symbol *> input(std::initializer_list<const char *> names)
+    {
+        std::vector<Symbol *> symbols;
+
+        for (const char *name : names)
+        {
+            symbols.push_back(manager.get_symbol(name));
+        }
+
+        return symbols;
+    }
+};
+
+TEST(GLR, Table)
+{
+    GLRGrammar grammar {
+        "%start S %end end %terminal a b %intermediate X\n"
+        "%grammar S: X a b [aab] | a a a [aaa] ;\n"
+        "X: a [x] ;\n"
+    };
+
+    ParseTable table { grammar.dfa, table_columns(grammar.manager) };
+    std::ostringstream out;
+
+    output_parse_table(table, out);
+
+    EXPECT_EQ(1, table.conflicts());
+    EXPECT_EQ(",end,a,b,S,X\r\n"
+              "1,,S3,,G2,G4\r\n"
+              "2,A,,,,\r\n"
+              "3,,S5/Rx,,,\r\n"
+              "4,,S6,,,\r\n"
+              "5,,S7,,,\r\n"
+              "6,,,S8,,\r\n"
+              "7,Raaa,,,,\r\n"
+              "8,Raab,,,,\r\n",
+              out.str());
+
+    auto aab = glr_parse(table, grammar.input({ "a", "a", "b", "end" }));
+    ASSERT_TRUE(aab.accepted);
+    EXPECT_EQ(1, count_derivations(aab.root));
+    EXPECT_EQ("aab", aab.root->families.front().production->name);
+
+    auto aaa = glr_parse(table, grammar.input({ "a", "a", "a", "end" }));
+    ASSERT_TRUE(aaa.accepted);
+    EXPECT_EQ("aaa", aaa.root->families.front().production->name);
+
+    auto error = glr_parse(table, grammar.input({ "a", "b", "end" }));
+    EXPECT_FALSE(error.accepted);
+    EXPECT_EQ(1, error.position);
+}
+
+TEST(GLR, Ambiguous)
+{
+    GLRGrammar grammar {
+        "%start E %end end %terminal num plus\n"
+        "%grammar E: E plus E [add] | num [num] ;\n"
+    };
+
+    ParseTable table { grammar.dfa, table_columns(grammar.manager) };
+
+    EXPECT_LT(0, collect_conflicts(grammar.dfa).size());
+
+    std::vector<std::size_t> catalan { 1, 1, 2, 5, 14, 42, 132 };
+
+    for (std::size_t n = 1; n <= catalan.size(); ++n)
+    {
+        std::vector<Symbol *> input { grammar.manager.get_symbol("num") };
+
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            input.push_back(grammar.manager.get_symbol("plus"));
+            input.push_back(grammar.manager.get_symbol("num"));
+        }
+
+        input.push_back(grammar.manager.get_symbol("end"));
+
+        auto result = glr_parse(table, input);
+
+        ASSERT_TRUE(result.accepted);
+        EXPECT_EQ(0, result.root->begin);
+        EXPECT_EQ(input.size() - 1, result.root->end);
+        EXPECT_EQ(catalan[n - 1], count_derivations(result.root));
+    }
+
+    std::vector<Symbol *> input { grammar.manager.get_symbol("num") };
+
+    for (std::size_t i = 1; i < 40; ++i)
+    {
+        input.push_back(grammar.manager.get_symbol("plus"));
+        input.push_back(grammar.manager.get_symbol("num"));
+    }
+
+    input.push_back(grammar.manager.get_symbol("end"));
+
+    auto result = glr_parse(table, input);
+
+    ASSERT_TRUE(result.accepted);
+    EXPECT_GT(input.size() * input.size(), result.forest.size());
+}
+
+TEST(GLR, Nullable)
+{
+    GLRGrammar grammar {
+        "%start S %end end %terminal x %intermediate A\n"
+        "%grammar S: A A x [s] ;\n"
+        "A: [empty] | x [one] ;\n"
+    };
+
+    ParseTable table { grammar.dfa, table_columns(grammar.manager) };
+
+    auto one = glr_parse(table, grammar.input({ "x", "end" }));
+    ASSERT_TRUE(one.accepted);
+    EXPECT_EQ(1, count_derivations(one.root));
+
+    auto two = glr_parse(table, grammar.input({ "x", "x", "end" }));
+    ASSERT_TRUE(two.accepted);
+    EXPECT_EQ(2, count_derivations(two.root));
+
+    auto three = glr_parse(table, grammar.input({ "x", "x", "x", "end" }));
+    ASSERT_TRUE(three.accepted);
+    EXPECT_EQ(1, count_derivations(three.root));
+
+    auto four = glr_parse(table, grammar.input({ "x", "x", "x", "x", "end" }));
+    EXPECT_FALSE(four.accepted);
+    EXPECT_EQ(3, four.position);
+}
+
+TEST(GLR, MultipleStarts)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/multi-start.grammar" };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    auto dfa = nfa_to_dfa(grammar_to_nfa(g));
+    ParseTable table { dfa, table_columns(manager) };
+
+    auto input = [&](std::initializer_list<const char *> names) {
+        std::vector<Symbol *> symbols;
+
+        for (const char *name : names)
+        {
+            symbols.push_back(manager.get_symbol(name));
+        }
+
+        return symbols;
+    };
+
+    auto stmt = input({ "ident", "assign", "number", "semicolon", "end" });
+    auto expr = input({ "number", "plus", "ident", "end" });
+
+    auto stmt_result = glr_parse(table, stmt, 1);
+    ASSERT_TRUE(stmt_result.accepted);
+    EXPECT_EQ("Stmt", stmt_result.root->symbol->name());
+    EXPECT_EQ("assignment", stmt_result.root->families.front().production->name);
+
+    auto expr_result = glr_parse(table, expr, 2);
+    ASSERT_TRUE(expr_result.accepted);
+    EXPECT_EQ("Expr", expr_result.root->symbol->name());
+    EXPECT_EQ(1, count_derivations(expr_result.root));
+
+    EXPECT_TRUE(glr_parse(table, stmt, 0).accepted);
+    EXPECT_FALSE(glr_parse(table, expr, 1).accepted);
+    EXPECT_FALSE(glr_parse(table, stmt, 2).accepted);
+}
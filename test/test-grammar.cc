@@ -86,7 +86,173 @@ TEST(Grammar, CalculateFirst)
 
     g.calculate();
 
-    EXPECT_EQ((std::set { &x, &y }), s.first());
-    EXPECT_EQ((std::set { &x }), a.first());
-    EXPECT_EQ((std::set { &y }), b.first());
+    EXPECT_EQ((First { &x, &y }), s.first());
+    EXPECT_EQ((First { &x }), a.first());
+    EXPECT_EQ((First { &y }), b.first());
+}
+
+TEST(Grammar, SuffixFirst)
+{
+    // S -> A B A
+    // A -> x
+    // A ->
+    // B -> y
+    // B ->
+    Symbol s { "S", SymbolType::intermediate };
+    Symbol a { "A", SymbolType::intermediate };
+    Symbol b { "B", SymbolType::intermediate };
+    Symbol x { "x", SymbolType::terminal };
+    Symbol y { "y", SymbolType::terminal };
+
+    Production p1 { "1", &s, std::vector { &a, &b, &a } };
+    Production p2 { "2", &a, std::vector { &x } };
+    Production p3 { "3", &a, std::vector<Symbol *> { } };
+    Production p4 { "4", &b, std::vector { &y } };
+    Production p5 { "5", &b, std::vector<Symbol *> { } };
+
+    Grammar g;
+
+    g.productions().push_back(&p1);
+    g.productions().push_back(&p2);
+    g.productions().push_back(&p3);
+    g.productions().push_back(&p4);
+    g.productions().push_back(&p5);
+
+    g.calculate();
+
+    SuffixFirstCatalog suffixes { g };
+
+    EXPECT_EQ((First { &x, &y }), suffixes.at(&p1, 0).first);
+    EXPECT_TRUE(suffixes.at(&p1, 0).nullable);
+    EXPECT_EQ((First { &x, &y }), suffixes.at(&p1, 1).first);
+    EXPECT_EQ((First { &x }), suffixes.at(&p1, 2).first);
+    EXPECT_EQ((First { }), suffixes.at(&p1, 3).first);
+    EXPECT_TRUE(suffixes.at(&p1, 3).nullable);
+
+    EXPECT_EQ((First { &x }), suffixes.at(&p2, 0).first);
+    EXPECT_FALSE(suffixes.at(&p2, 0).nullable);
+    EXPECT_TRUE(suffixes.at(&p2, 1).nullable);
+    EXPECT_TRUE(suffixes.at(&p3, 0).nullable);
+
+    for (Production *p : g.productions())
+    {
+        for (std::size_t i = 0; i <= p->rhs.size(); ++i)
+        {
+            std::ranges::subrange suffix { p->rhs.begin() + i, p->rhs.end() };
+
+            EXPECT_EQ(first(suffix), suffixes.at(p, i).first);
+            EXPECT_EQ(is_nullable(suffix), suffixes.at(p, i).nullable);
+        }
+    }
+}
+
+TEST(Grammar, Follow)
+{
+    // S -> A B x
+    // A -> y A
+    // A ->
+    // B -> A
+    Symbol s { "S", SymbolType::intermediate };
+    Symbol a { "A", SymbolType::intermediate };
+    Symbol b { "B", SymbolType::intermediate };
+    Symbol x { "x", SymbolType::terminal };
+    Symbol y { "y", SymbolType::terminal };
+    Symbol end { "end", SymbolType::terminal };
+
+    Production p1 { "1", &s, std::vector { &a, &b, &x } };
+    Production p2 { "2", &a, std::vector { &y, &a } };
+    Production p3 { "3", &a, std::vector<Symbol *> { } };
+    Production p4 { "4", &b, std::vector { &a } };
+
+    Grammar g;
+    g.set_start(&s);
+    g.set_end(&end);
+
+    g.productions().push_back(&p1);
+    g.productions().push_back(&p2);
+    g.productions().push_back(&p3);
+    g.productions().push_back(&p4);
+
+    g.calculate();
+
+    auto follows = follow_sets(g, SuffixFirstCatalog { g });
+
+    EXPECT_EQ((First { &end }), follows.at(&s));
+    EXPECT_EQ((First { &x, &y }), follows.at(&a));
+    EXPECT_EQ((First { &x }), follows.at(&b));
+}
+
+TEST(Grammar, Reduce)
+{
+    // S -> A
+    // A -> x
+    // A -> y B
+    // B -> B y
+    // C -> x
+    SymbolManager manager;
+    auto s = manager.create_symbol("S", SymbolType::intermediate);
+    auto a = manager.create_symbol("A", SymbolType::intermediate);
+    auto b = manager.create_symbol("B", SymbolType::intermediate);
+    auto c = manager.create_symbol("C", SymbolType::intermediate);
+    auto x = manager.create_symbol("x", SymbolType::terminal);
+    auto y = manager.create_symbol("y", SymbolType::terminal);
+    auto z = manager.create_symbol("z", SymbolType::terminal);
+    auto end = manager.create_symbol("end", SymbolType::terminal);
+
+    Production p1 { "1", s, std::vector { a } };
+    Production p2 { "2", a, std::vector { x } };
+    Production p3 { "3", a, std::vector { y, b } };
+    Production p4 { "4", b, std::vector { b, y } };
+    Production p5 { "5", c, std::vector { x } };
+
+    Grammar g;
+
+    g.set_start(s);
+    g.set_end(end);
+
+    for (Production *p : { &p1, &p2, &p3, &p4, &p5 })
+    {
+        g.productions().push_back(p);
+    }
+
+    g.calculate();
+
+    EXPECT_EQ((First { x, y }), s->first());
+
+    auto reduction = g.reduce(manager);
+
+    EXPECT_EQ((std::vector { b }), reduction.unproductive);
+    EXPECT_EQ((std::vector { c, y, z }), reduction.unreachable);
+    EXPECT_EQ((ProductionCatalog { &p3, &p4, &p5 }), reduction.removed);
+    EXPECT_EQ((ProductionCatalog { &p1, &p2 }), g.productions());
+
+    EXPECT_TRUE(b->is_useless());
+    EXPECT_TRUE(c->is_useless());
+    EXPECT_TRUE(z->is_useless());
+    EXPECT_FALSE(a->is_useless());
+    EXPECT_FALSE(end->is_useless());
+
+    EXPECT_EQ((First { x }), s->first());
+    EXPECT_EQ((First { x }), a->first());
+}
+
+TEST(Grammar, ReduceEmptyLanguage)
+{
+    // S -> S x
+    SymbolManager manager;
+    auto s = manager.create_symbol("S", SymbolType::intermediate);
+    auto x = manager.create_symbol("x", SymbolType::terminal);
+    auto end = manager.create_symbol("end", SymbolType::terminal);
+
+    Production p1 { "1", s, std::vector { s, x } };
+
+    Grammar g;
+
+    g.set_start(s);
+    g.set_end(end);
+    g.productions().push_back(&p1);
+
+    g.calculate();
+
+    EXPECT_THROW(g.reduce(manager), std::runtime_error);
 }
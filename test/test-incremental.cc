@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include "incremental.hh"
+#include "input.hh"
+#include "output.hh"
+
+#include <sstream>
+
+using namespace lr1cc;
+
+static const char *const declarations =
+    "%start Exprs\n"
+    "%end end\n"
+    "%terminal symbol integer sparen eparen quote dot\n"
+    "%intermediate Expr ListTail\n";
+
+static const char *const base_grammar =
+    "%grammar\n"
+    "Exprs: Exprs Expr [some-exprs] | [no-exprs] ;\n"
+    "Expr: symbol [symbol-expr]\n"
+    "    | integer [integer-expr]\n"
+    "    | sparen Exprs ListTail eparen [list-expr]\n"
+    "    ;\n"
+    "ListTail: [proper-list-tail] ;\n";
+
+static std::vector<std::string> rebuilt_rows(const std::string &grammar)
+{
+    std::istringstream in { declarations + grammar };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+
+    auto dfa = nfa_to_dfa(grammar_to_nfa(g));
+
+    return lr1_table_rows(dfa, table_columns(manager));
+}
+
+TEST(Incremental, MatchesRebuild)
+{
+    std::istringstream in { std::string { declarations } + base_grammar };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+
+    auto columns = table_columns(manager);
+
+    Automaton automaton { g, columns };
+
+    EXPECT_EQ(rebuilt_rows(base_grammar), lr1_table_rows(automaton.dfa(), columns));
+
+    auto expr = manager.get_symbol("Expr");
+    auto list_tail = manager.get_symbol("ListTail");
+
+    Production quote_expr { "quote-expr", expr, std::vector { manager.get_symbol("quote"), expr } };
+    Production improper { "improper-list-tail", list_tail, std::vector { manager.get_symbol("dot"), expr } };
+
+    auto update1 = automaton.update(ProductionDiff { { &quote_expr, &improper }, { } }, columns);
+
+    std::string grammar1 = std::string { base_grammar }
+        + "Expr: quote Expr [quote-expr] ;\n"
+        + "ListTail: dot Expr [improper-list-tail] ;\n";
+
+    EXPECT_EQ(rebuilt_rows(grammar1), lr1_table_rows(automaton.dfa(), columns));
+    EXPECT_FALSE(update1.changed_rows.empty());
+
+    auto integer_expr = g.productions().at(3);
+    ASSERT_EQ("integer-expr", integer_expr->name);
+
+    auto update2 = automaton.update(ProductionDiff { { }, { integer_expr } }, columns);
+
+    std::string grammar2 =
+        "%grammar\n"
+        "Exprs: Exprs Expr [some-exprs] | [no-exprs] ;\n"
+        "Expr: symbol [symbol-expr]\n"
+        "    | sparen Exprs ListTail eparen [list-expr]\n"
+        "    ;\n"
+        "ListTail: [proper-list-tail] ;\n"
+        "Expr: quote Expr [quote-expr] ;\n"
+        "ListTail: dot Expr [improper-list-tail] ;\n";
+
+    EXPECT_EQ(rebuilt_rows(grammar2), lr1_table_rows(automaton.dfa(), columns));
+    EXPECT_FALSE(update2.changed_rows.empty());
+    EXPECT_GT(update2.removed_rows, 0);
+
+    auto update3 = automaton.update(ProductionDiff { }, columns);
+
+    EXPECT_TRUE(update3.changed_rows.empty());
+    EXPECT_EQ(0, update3.removed_rows);
+}
+
+TEST(Incremental, NullableChange)
+{
+    std::istringstream in { std::string { declarations } + base_grammar };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+
+    auto columns = table_columns(manager);
+
+    Automaton automaton { g, columns };
+
+    auto list_tail = manager.get_symbol("ListTail");
+    auto proper = g.productions().back();
+    ASSERT_EQ("proper-list-tail", proper->name);
+
+    Production improper { "improper-list-tail", list_tail, std::vector { manager.get_symbol("dot"), manager.get_symbol("Expr") } };
+
+    automaton.update(ProductionDiff { { &improper }, { proper } }, columns);
+
+    std::string grammar1 =
+        "%grammar\n"
+        "Exprs: Exprs Expr [some-exprs] | [no-exprs] ;\n"
+        "Expr: symbol [symbol-expr]\n"
+        "    | integer [integer-expr]\n"
+        "    | sparen Exprs ListTail eparen [list-expr]\n"
+        "    ;\n"
+        "ListTail: dot Expr [improper-list-tail] ;\n";
+
+    EXPECT_FALSE(list_tail->is_nullable());
+    EXPECT_EQ(rebuilt_rows(grammar1), lr1_table_rows(automaton.dfa(), columns));
+
+    automaton.update(ProductionDiff { { proper }, { &improper } }, columns);
+
+    EXPECT_TRUE(list_tail->is_nullable());
+    EXPECT_EQ(rebuilt_rows(base_grammar), lr1_table_rows(automaton.dfa(), columns));
+}
+
+TEST(Incremental, StableRowIdentity)
+{
+    std::istringstream in { std::string { declarations } + base_grammar };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+
+    auto columns = table_columns(manager);
+
+    Automaton automaton { g, columns };
+
+    auto old_rows = lr1_table_rows(automaton.dfa(), columns);
+
+    auto dot = manager.get_symbol("dot");
+    Production improper { "improper-list-tail", manager.get_symbol("ListTail"), std::vector { dot, manager.get_symbol("Expr") } };
+
+    auto update1 = automaton.update(ProductionDiff { { &improper }, { } }, columns);
+    auto new_rows = lr1_table_rows(automaton.dfa(), columns);
+
+    ASSERT_LT(old_rows.size(), new_rows.size());
+    EXPECT_EQ(0, update1.removed_rows);
+
+    // Rows after the first new state are shifted, but only those which
+    // gained an action on dot, and the new rows, are reported.
+    auto dot_column = std::ranges::find(columns, dot) - columns.begin();
+    std::size_t with_dot = 0;
+
+    for (std::size_t i = 0; i < new_rows.size(); ++i)
+    {
+        std::istringstream cells { new_rows[i] };
+        std::string cell;
+
+        for (std::ptrdiff_t j = 0; j <= dot_column + 1; ++j)
+        {
+            std::getline(cells, cell, ',');
+        }
+
+        if (!cell.empty())
+        {
+            ++with_dot;
+            EXPECT_TRUE(std::ranges::find(update1.changed_rows, i + 1) != update1.changed_rows.end()) << new_rows[i];
+        }
+    }
+
+    EXPECT_GE(with_dot + new_rows.size() - old_rows.size(), update1.changed_rows.size());
+    EXPECT_GT(new_rows.size() - update1.changed_rows.front() + 1, update1.changed_rows.size());
+
+    auto update2 = automaton.update(ProductionDiff { { }, { &improper } }, columns);
+
+    EXPECT_EQ(old_rows, lr1_table_rows(automaton.dfa(), columns));
+    EXPECT_GE(with_dot, update2.changed_rows.size());
+    EXPECT_EQ(new_rows.size() - old_rows.size(), update2.removed_rows);
+
+    // Named states created for new lookaheads are kept, but the item
+    // states replaced by an edit are freed.
+    auto nfa_states = std::ranges::distance(automaton.nfa().states());
+
+    for (int i = 0; i < 3; ++i)
+    {
+        automaton.update(ProductionDiff { { &improper }, { } }, columns);
+        automaton.update(ProductionDiff { { }, { &improper } }, columns);
+    }
+
+    EXPECT_EQ(nfa_states, std::ranges::distance(automaton.nfa().states()));
+}
@@ -2,7 +2,10 @@
 #include <gtest/gtest.h>
 
 #include "input.hh"
+#include "mapped-file.hh"
 
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 
 using namespace lr1cc;
@@ -56,6 +59,70 @@ TEST(Lexer, Fundamental)
     expect_next_token(lexer, TokenType::end, 5);
 }
 
+TEST(Lexer, Buffer)
+{
+    std::string_view buffer {
+        "identifier_longer_than_a_block        \n"
+        "\n\n \t\r\n          x%grammar %include \"dir/common.grammar\" # comment without newline"
+    };
+
+    Lexer lexer { buffer };
+
+    auto &tok = lexer.front();
+    EXPECT_EQ(TokenType::ident, tok.type);
+    EXPECT_EQ("identifier_longer_than_a_block", tok.value);
+    EXPECT_EQ(buffer.data(), tok.value.data());
+    lexer.pop();
+
+    expect_next_token(lexer, TokenType::ident, "x", 5);
+    expect_next_token(lexer, TokenType::grammar_marker, 5);
+    expect_next_token(lexer, TokenType::include_marker, 5);
+    expect_next_token(lexer, TokenType::string, "dir/common.grammar", 5);
+    expect_next_token(lexer, TokenType::end, 5);
+}
+
+TEST(Lexer, Error)
+{
+    Lexer lexer1 { std::string_view { "\n\nS @" } };
+    expect_next_token(lexer1, TokenType::ident, "S", 3);
+    EXPECT_THROW(lexer1.front(), std::runtime_error);
+
+    Lexer lexer2 { std::string_view { "%section" } };
+    EXPECT_THROW(lexer2.front(), std::runtime_error);
+
+    Lexer lexer3 { std::string_view { "%include \"common.grammar\n\"" } };
+    expect_next_token(lexer3, TokenType::include_marker, 1);
+    EXPECT_THROW(lexer3.front(), std::runtime_error);
+}
+
+TEST(MappedFile, Fundamental)
+{
+    auto directory = std::filesystem::temp_directory_path() / "lr1cc-test-mapped-file";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    {
+        std::ofstream out { directory / "grammar", std::ios::binary };
+        out << "%start S\n";
+    }
+
+    {
+        std::ofstream out { directory / "empty", std::ios::binary };
+    }
+
+    MappedFile file { (directory / "grammar").string() };
+    EXPECT_EQ("%start S\n", file.view());
+
+    MappedFile moved { std::move(file) };
+    EXPECT_EQ("%start S\n", moved.view());
+    EXPECT_TRUE(file.view().empty());
+
+    EXPECT_TRUE(MappedFile { (directory / "empty").string() }.view().empty());
+    EXPECT_THROW(MappedFile { (directory / "none").string() }, std::runtime_error);
+
+    std::filesystem::remove_all(directory);
+}
+
 TEST(Parser, Fundamental)
 {
     std::istringstream in {
@@ -103,3 +170,30 @@ TEST(Parser, Fundamental)
     EXPECT_EQ("y", g.productions().at(3)->rhs.at(0)->name());
     EXPECT_EQ("x", g.productions().at(3)->rhs.at(1)->name());
 }
+
+TEST(Parser, MultipleStarts)
+{
+    std::istringstream in {
+        "%start S T %end end\n"
+        "%start U\n"
+        "%terminal x\n"
+        "%grammar\n"
+        "S: T [t] ;\n"
+        "T: U [u] ;\n"
+        "U: x [x] ;\n"
+    };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    Grammar g = parse_input(in, manager, productions);
+
+    ASSERT_EQ(3, g.starts().size());
+    EXPECT_EQ("S", g.start()->name());
+    EXPECT_EQ("T", g.starts().at(1)->name());
+    EXPECT_EQ("U", g.starts().at(2)->name());
+
+    std::istringstream redeclared { "%start S S %end end\n" };
+
+    EXPECT_THROW(parse_input(redeclared, manager, productions), std::runtime_error);
+}
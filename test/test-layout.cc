@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include "generate.hh"
+#include "input.hh"
+#include "layout.hh"
+#include "runtime.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <ranges>
+#include <sstream>
+
+using namespace lr1cc;
+
+class LayoutTest : public ::testing::Test
+{
+
+protected:
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+    std::optional<Grammar> grammar;
+    DFA dfa;
+    std::vector<Symbol *> columns;
+    std::vector<std::vector<Symbol *>> sentences;
+
+    void SetUp() override
+    {
+        std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/arithmetic.grammar" };
+
+        grammar.emplace(parse_input(in, manager, productions));
+        grammar->calculate();
+        grammar->ensure_sanity();
+
+        dfa = nfa_to_dfa(grammar_to_nfa(grammar.value()));
+        columns = table_columns(manager);
+
+        SentenceGenerator generator { grammar.value(), GeneratorOptions { 20000, 16, 3 } };
+        sentences.emplace_back();
+
+        generator.generate(
+            [&](Symbol *s) {
+                sentences.back().push_back(s);
+
+                if (s == grammar->end())
+                {
+                    sentences.emplace_back();
+                }
+            });
+
+        sentences.pop_back();
+    }
+
+};
+
+TEST_F(LayoutTest, Paths)
+{
+    auto paths = state_access_paths(dfa);
+    auto layout = dfs_layout(dfa, columns);
+    ParseTable table { layout };
+
+    auto table_paths = table_access_paths(table);
+
+    ASSERT_EQ(layout.rows.size(), table_paths.size());
+    EXPECT_EQ(paths.size(), table_paths.size());
+    EXPECT_EQ("", table_paths[0]);
+
+    for (std::size_t row = 0; row < layout.rows.size(); ++row)
+    {
+        EXPECT_EQ(paths.at(layout.rows[row]), table_paths[row]);
+    }
+}
+
+TEST_F(LayoutTest, Equivalent)
+{
+    ParseTable bfs { bfs_layout(dfa, columns) };
+    ParseTable dfs { dfs_layout(dfa, columns) };
+
+    EXPECT_EQ(dfa.start(), dfs_layout(dfa, columns).rows.front());
+    EXPECT_EQ(bfs.rows(), dfs.rows());
+
+    LRParser bfs_parser { bfs };
+    LRParser dfs_parser { dfs };
+
+    for (const auto &sentence : sentences)
+    {
+        auto expected = bfs_parser.parse(std::span { sentence });
+        auto actual = dfs_parser.parse(std::span { sentence });
+
+        EXPECT_TRUE(expected.accepted);
+        EXPECT_EQ(expected.accepted, actual.accepted);
+        EXPECT_EQ(expected.reductions, actual.reductions);
+    }
+
+    std::vector<Symbol *> error { manager.get_symbol("number"), manager.get_symbol("number") };
+    EXPECT_FALSE(dfs_parser.parse(std::span { error }).accepted);
+    EXPECT_EQ(1, dfs_parser.parse(std::span { error }).position);
+}
+
+TEST_F(LayoutTest, Profile)
+{
+    ParseTable dfs { dfs_layout(dfa, columns) };
+    TableProfile hits { dfs };
+    LRParser profiler { dfs, &hits };
+
+    for (const auto &sentence : sentences)
+    {
+        profiler.parse(std::span { sentence });
+    }
+
+    std::stringstream file;
+    write_profile(table_profile(dfs, hits), file);
+
+    auto profile = read_profile(file);
+    auto layout = profile_layout(dfa, columns, profile);
+    ParseTable hot { layout };
+    TableProfile hot_hits { hot };
+    LRParser parser { hot, &hot_hits };
+
+    for (const auto &sentence : sentences)
+    {
+        EXPECT_TRUE(parser.parse(std::span { sentence }).accepted);
+    }
+
+    EXPECT_EQ(dfa.start(), layout.rows.front());
+    EXPECT_TRUE(std::ranges::is_sorted(hot_hits.row_hits.begin() + 1, hot_hits.row_hits.end(), std::greater { }));
+
+    auto terminals = std::ranges::count_if(layout.columns, [](Symbol *s) { return s->is_terminal(); });
+    EXPECT_TRUE(std::ranges::is_sorted(hot_hits.column_hits.begin(), hot_hits.column_hits.begin() + terminals, std::greater { }));
+    EXPECT_TRUE(std::ranges::is_sorted(hot_hits.column_hits.begin() + terminals, hot_hits.column_hits.end(), std::greater { }));
+}
+
+TEST(Layout, ReadProfile)
+{
+    std::istringstream in {
+        "# comment\n"
+        "state 10\n"
+        "state 3 sparen number\n"
+        "symbol 7 number\n"
+        "state 2 sparen  number\n"
+    };
+
+    auto profile = read_profile(in);
+
+    EXPECT_EQ(10, profile.states.at(""));
+    EXPECT_EQ(5, profile.states.at("sparen number"));
+    EXPECT_EQ(7, profile.symbols.at("number"));
+
+    std::istringstream bad1 { "state many\n" };
+    EXPECT_THROW(read_profile(bad1), std::runtime_error);
+
+    std::istringstream bad2 { "symbol 1 a b\n" };
+    EXPECT_THROW(read_profile(bad2), std::runtime_error);
+
+    std::istringstream bad3 { "row 1 a\n" };
+    EXPECT_THROW(read_profile(bad3), std::runtime_error);
+}
+
+TEST(Layout, MultipleStarts)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/multi-start.grammar" };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    DFA dfa = nfa_to_dfa(grammar_to_nfa(g));
+    auto columns = table_columns(manager);
+
+    for (const auto &layout : { bfs_layout(dfa, columns), dfs_layout(dfa, columns) })
+    {
+        ASSERT_EQ(3, layout.entries);
+        EXPECT_TRUE(std::ranges::equal(dfa.starts(), layout.rows | std::views::take(3)));
+
+        ParseTable table { layout };
+        auto paths = state_access_paths(dfa);
+        auto table_paths = table_access_paths(table);
+
+        EXPECT_EQ("", table_paths[0]);
+        EXPECT_EQ("%2", table_paths[1]);
+        EXPECT_EQ("%3", table_paths[2]);
+
+        for (std::size_t row = 0; row < layout.rows.size(); ++row)
+        {
+            EXPECT_EQ(paths.at(layout.rows[row]), table_paths[row]);
+        }
+    }
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include "library.hh"
+#include "runtime.hh"
+
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+
+using namespace lr1cc;
+
+static_assert(!std::is_copy_constructible_v<TableResult>);
+static_assert(std::is_nothrow_move_constructible_v<TableResult>);
+
+static std::string read_sample(const char *name)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + name };
+    std::ostringstream content;
+    content << in.rdbuf();
+
+    return content.str();
+}
+
+static std::vector<std::uint32_t> tokens(const TableResult &result, const std::vector<std::string> &names)
+{
+    std::vector<std::uint32_t> indices;
+
+    for (const auto &name : names)
+    {
+        for (std::uint32_t i = 0; i < result.terminals; ++i)
+        {
+            if (result.symbols[i].name == name)
+            {
+                indices.push_back(i);
+            }
+        }
+    }
+
+    return indices;
+}
+
+// A parser over the dense arrays alone.
+static bool dense_parse(const TableResult &result, const std::vector<std::uint32_t> &input)
+{
+    std::vector<std::uint32_t> stack { 0 };
+    std::size_t position = 0;
+
+    while (position < input.size())
+    {
+        const ActionCell &cell = result.action(stack.back(), input[position]);
+
+        switch (cell.type)
+        {
+        case CellType::error:
+            return false;
+        case CellType::accept:
+            return true;
+        case CellType::shift:
+            stack.push_back(cell.value);
+            ++position;
+            break;
+        case CellType::reduce:
+        {
+            const ProductionInfo &p = result.productions[cell.value];
+            stack.resize(stack.size() - p.rhs.size());
+
+            auto to_row = result.go(stack.back(), p.lhs - result.terminals);
+
+            if (to_row == no_goto)
+            {
+                return false;
+            }
+
+            stack.push_back(to_row);
+            break;
+        }
+        }
+    }
+
+    return false;
+}
+
+TEST(Library, Arithmetic)
+{
+    auto result = build_table(read_sample("/arithmetic.grammar"));
+
+    ASSERT_EQ(BuildStatus::success, result.status) << result.diagnostics;
+    ASSERT_TRUE(result.table.has_value());
+
+    EXPECT_EQ(result.table->rows(), result.rows);
+    EXPECT_EQ(result.table->columns().size(), result.symbols.size());
+    EXPECT_EQ(result.rows * result.terminals, result.actions.size());
+    EXPECT_EQ(result.rows * (result.symbols.size() - result.terminals), result.gotos.size());
+    EXPECT_EQ(12, result.productions.size());
+    ASSERT_EQ(1, result.starts.size());
+    EXPECT_EQ("AddExpr", result.symbols[result.starts.front()].name);
+    EXPECT_TRUE(result.conflicts.empty());
+    EXPECT_EQ(result.rows, result.stats.table.rows);
+
+    for (std::size_t i = 0; i < result.symbols.size(); ++i)
+    {
+        EXPECT_EQ(i < result.terminals, result.symbols[i].terminal);
+        EXPECT_EQ(result.table->columns()[i]->name(), result.symbols[i].name);
+    }
+
+    std::vector<std::vector<std::string>> sentences {
+        { "number", "end" },
+        { "minus", "ident", "mul", "sparen", "number", "plus", "number", "eparen", "end" },
+        { "number", "div", "plus", "ident", "minus", "number", "end" },
+        { "number", "plus", "end" },
+        { "sparen", "number", "end" },
+        { "eparen", "end" },
+    };
+
+    LRParser parser { result.table.value() };
+
+    for (const auto &sentence : sentences)
+    {
+        auto input = tokens(result, sentence);
+
+        ASSERT_EQ(sentence.size(), input.size());
+        EXPECT_EQ(parser.parse(input).accepted, dense_parse(result, input));
+    }
+
+    EXPECT_TRUE(dense_parse(result, tokens(result, sentences[1])));
+    EXPECT_FALSE(dense_parse(result, tokens(result, sentences[3])));
+}
+
+TEST(Library, Conflict)
+{
+    auto result = build_table(read_sample("/sr-conflict.grammar"));
+
+    EXPECT_EQ(BuildStatus::conflict, result.status);
+    EXPECT_FALSE(result.table.has_value());
+    EXPECT_TRUE(result.actions.empty());
+    ASSERT_FALSE(result.conflicts.empty());
+    EXPECT_FALSE(result.conflicts.front().reduce_reduce);
+    EXPECT_NE(std::string::npos, result.diagnostics.find("detected."));
+    EXPECT_NE(std::string::npos, result.diagnostics.find(result.conflicts.front().report));
+
+    auto rr = build_table(read_sample("/rr-conflict.grammar"));
+
+    EXPECT_EQ(BuildStatus::conflict, rr.status);
+    ASSERT_FALSE(rr.conflicts.empty());
+    EXPECT_TRUE(rr.conflicts.front().reduce_reduce);
+}
+
+TEST(Library, GLR)
+{
+    auto result = build_table(read_sample("/sr-conflict.grammar"), BuildOptions { .glr = true });
+
+    ASSERT_EQ(BuildStatus::success, result.status) << result.diagnostics;
+    ASSERT_TRUE(result.table.has_value());
+    EXPECT_FALSE(result.conflicts.empty());
+
+    std::size_t multiple = 0;
+
+    for (std::size_t row = 0; row < result.rows; ++row)
+    {
+        for (std::size_t column = 0; column < result.terminals; ++column)
+        {
+            auto actions = result.table->actions(row, column);
+
+            if (actions.size() > 1)
+            {
+                ++multiple;
+                EXPECT_NE(CellType::error, result.action(row, column).type);
+            }
+        }
+    }
+
+    EXPECT_LT(0, multiple);
+}
+
+TEST(Library, Failure)
+{
+    auto result = build_table("%start S\n%grammar\nS: undefined ;\n", BuildOptions { .input_name = "broken" });
+
+    EXPECT_EQ(BuildStatus::failure, result.status);
+    EXPECT_NE(std::string::npos, result.diagnostics.find("error:"));
+    EXPECT_FALSE(result.table.has_value());
+
+    auto moved = std::move(result);
+
+    EXPECT_EQ(BuildStatus::failure, moved.status);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include "cache.hh"
+#include "input.hh"
+#include "module.hh"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace lr1cc;
+
+static void write_file(const std::filesystem::path &path, std::string_view content)
+{
+    std::ofstream out { path, std::ios::binary };
+    out << content;
+}
+
+class ModuleTest : public ::testing::Test
+{
+
+protected:
+
+    std::filesystem::path directory;
+
+    void SetUp() override
+    {
+        directory = std::filesystem::temp_directory_path() / "lr1cc-test-module";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory / "common");
+
+        write_file(directory / "common" / "expr.grammar",
+            "%terminal num plus\n"
+            "%intermediate Expr\n"
+            "%include \"term.grammar\"\n"
+            "%grammar Expr: Expr plus Term [add] | Term [term] ;\n");
+
+        write_file(directory / "common" / "term.grammar",
+            "%intermediate Term\n"
+            "%grammar Term: num [num] ;\n");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::string canonical(std::string_view text, const std::filesystem::path &path, ModuleCache &cache)
+    {
+        SymbolManager manager;
+        std::vector<std::unique_ptr<Production>> productions;
+        std::vector<ModuleSource> sources;
+
+        auto g = parse_input(text, path.string(), cache, sources, manager, productions);
+
+        return canonical_grammar(g, manager, "");
+    }
+
+};
+
+TEST_F(ModuleTest, Include)
+{
+    ModuleCache cache;
+
+    auto included = canonical(
+        "%start S %end end\n"
+        "%include \"common/expr.grammar\"\n"
+        "%grammar S: Expr [expr] ;\n",
+        directory / "main.grammar", cache);
+
+    auto inlined = canonical(
+        "%start S %end end\n"
+        "%terminal num plus\n"
+        "%intermediate Expr\n"
+        "%intermediate Term\n"
+        "%grammar Term: num [num] ;\n"
+        "%grammar Expr: Expr plus Term [add] | Term [term] ;\n"
+        "%grammar S: Expr [expr] ;\n",
+        directory / "inlined.grammar", cache);
+
+    EXPECT_EQ(inlined, included);
+    EXPECT_EQ(0, cache.hits());
+    EXPECT_EQ(2, cache.misses());
+}
+
+TEST_F(ModuleTest, Cache)
+{
+    ModuleCache cache;
+
+    auto a = canonical(
+        "%start A %end end\n"
+        "%include \"common/expr.grammar\"\n"
+        "%grammar A: Expr [a] ;\n",
+        directory / "a.grammar", cache);
+
+    auto b = canonical(
+        "%start B %end end\n"
+        "%include \"common/expr.grammar\"\n"
+        "%include \"common/term.grammar\"\n"
+        "%grammar B: Expr [b] ;\n",
+        directory / "b.grammar", cache);
+
+    EXPECT_EQ(2, cache.hits());
+    EXPECT_EQ(2, cache.misses());
+    EXPECT_NE(std::string::npos, a.find("add"));
+    EXPECT_NE(std::string::npos, b.find("add"));
+
+    write_file(directory / "common" / "term.grammar",
+        "%intermediate Term\n"
+        "%grammar Term: num [num] | Term num [nums] ;\n");
+
+    auto c = canonical(
+        "%start C %end end\n"
+        "%include \"common/expr.grammar\"\n"
+        "%grammar C: Expr [c] ;\n",
+        directory / "c.grammar", cache);
+
+    EXPECT_EQ(3, cache.hits());
+    EXPECT_EQ(3, cache.misses());
+    EXPECT_NE(std::string::npos, c.find("nums"));
+}
+
+TEST_F(ModuleTest, Error)
+{
+    ModuleCache cache;
+
+    try
+    {
+        canonical("%start S %end end\n\n%include \"none.grammar\"\n", directory / "main.grammar", cache);
+        FAIL();
+    }
+    catch (std::runtime_error &e)
+    {
+        EXPECT_EQ("error: failed to include `" + (directory / "none.grammar").string() + "' at line 3.\n", e.what());
+    }
+
+    write_file(directory / "broken.grammar", "%grammar\nS: Undefined [s] ;\n");
+
+    try
+    {
+        canonical("%start S %end end\n%include \"broken.grammar\"\n", directory / "main.grammar", cache);
+        FAIL();
+    }
+    catch (std::runtime_error &e)
+    {
+        EXPECT_EQ("error: unknown symbol `Undefined' at line 2.\n"
+                  "note: in `" + (directory / "broken.grammar").string() + "' included at line 2.\n",
+                  e.what());
+    }
+
+    EXPECT_THROW(canonical("%include common/expr.grammar\n", directory / "main.grammar", cache), std::runtime_error);
+}
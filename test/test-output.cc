@@ -53,3 +53,19 @@ TEST(Output, Fundamental)
 
     EXPECT_EQ(expect, result);
 }
+
+TEST(Output, Columns)
+{
+    SymbolManager manager;
+    auto s = manager.create_symbol("S", SymbolType::intermediate);
+    auto a = manager.create_symbol("A", SymbolType::intermediate);
+    auto x = manager.create_symbol("x", SymbolType::terminal);
+    auto y = manager.create_symbol("y", SymbolType::terminal);
+
+    EXPECT_EQ((std::vector { x, y, s, a }), table_columns(manager));
+
+    a->set_useless();
+    y->set_useless();
+
+    EXPECT_EQ((std::vector { x, s }), table_columns(manager));
+}
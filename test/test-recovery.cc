@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include "generate.hh"
+#include "input.hh"
+#include "recovery.hh"
+#include "runtime.hh"
+
+#include <fstream>
+#include <sstream>
+
+using namespace lr1cc;
+
+struct RecoveryGrammar
+{
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+    Grammar grammar;
+    ParseTable table;
+
+    explicit RecoveryGrammar(std::istream &in)
+        : grammar { parse_input(in, manager, productions) },
+          table { build() }
+    {
+    }
+
+    ParseTable build()
+    {
+        grammar.calculate();
+        grammar.ensure_sanity();
+
+        return ParseTable { nfa_to_dfa(grammar_to_nfa(grammar)), table_columns(manager) };
+    }
+
+    std::vector<std::uint32_t> input(std::initializer_list<const char *> names)
+    {
+        std::vector<std::uint32_t> columns;
+
+        for (const char *name : names)
+        {
+            columns.push_back(static_cast<std::uint32_t>(table.column(manager.get_symbol(name)).value()));
+        }
+
+        return columns;
+    }
+};
+
+TEST(Recovery, Table)
+{
+    std::istringstream in {
+        "%start S %end end %terminal a b\n"
+        "%grammar S: a S b [more-ab] | [no-more-ab] ;\n"
+    };
+
+    RecoveryGrammar g { in };
+    RecoveryTable recovery { g.table };
+    std::ostringstream out;
+
+    output_recovery_table(g.table, recovery, out);
+
+    EXPECT_EQ(",expected,insert,sync\r\n"
+              "1,3,a,S\r\n"
+              "2,1,,\r\n"
+              "3,6,a,S\r\n"
+              "4,4,b,\r\n"
+              "5,6,a,S\r\n"
+              "6,1,,\r\n"
+              "7,4,b,\r\n"
+              "8,4,,\r\n",
+              out.str());
+
+    EXPECT_EQ(3, recovery.terminals());
+    EXPECT_TRUE(recovery.expects(0, 1));
+    EXPECT_FALSE(recovery.expects(0, 2));
+    EXPECT_FALSE(recovery.expects(0, 3));
+}
+
+TEST(Recovery, Arithmetic)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/arithmetic.grammar" };
+
+    RecoveryGrammar g { in };
+    RecoveryTable recovery { g.table };
+    LRParser parser { g.table };
+
+    for (std::size_t row = 0; row < g.table.rows(); ++row)
+    {
+        for (std::size_t column = 0; column < recovery.terminals(); ++column)
+        {
+            EXPECT_EQ(!g.table.actions(row, column).empty(), recovery.expects(row, column));
+        }
+    }
+
+    std::vector<ParseError> errors;
+
+    auto missing_operand = g.input({ "number", "plus", "end" });
+    auto result = parser.parse(missing_operand, recovery, errors);
+
+    EXPECT_TRUE(result.accepted);
+    ASSERT_EQ(1, errors.size());
+    EXPECT_EQ(2, errors[0].position);
+    EXPECT_EQ(RepairType::insertion, errors[0].repair);
+    EXPECT_EQ("number", g.table.columns()[errors[0].symbol]->name());
+
+    errors.clear();
+
+    auto missing_operator = g.input({ "number", "number", "end" });
+    result = parser.parse(missing_operator, recovery, errors);
+
+    EXPECT_TRUE(result.accepted);
+    ASSERT_EQ(1, errors.size());
+    EXPECT_EQ(1, errors[0].position);
+    EXPECT_EQ(RepairType::deletion, errors[0].repair);
+
+    errors.clear();
+
+    auto extra_paren = g.input({ "number", "eparen", "plus", "number", "end" });
+    result = parser.parse(extra_paren, recovery, errors);
+
+    EXPECT_TRUE(result.accepted);
+    ASSERT_EQ(1, errors.size());
+    EXPECT_EQ(RepairType::deletion, errors[0].repair);
+
+    errors.clear();
+
+    auto garbage = g.input({ "sparen", "number", "mul", "eparen", "eparen", "div", "number", "end" });
+    result = parser.parse(garbage, recovery, errors);
+
+    EXPECT_TRUE(result.accepted);
+    ASSERT_LE(1, errors.size());
+    EXPECT_EQ(3, errors[0].position);
+    EXPECT_FALSE(parser.parse(std::span<const std::uint32_t> { garbage }).accepted);
+}
+
+TEST(Recovery, Generated)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/arithmetic.grammar" };
+
+    RecoveryGrammar g { in };
+    RecoveryTable recovery { g.table };
+    LRParser parser { g.table };
+
+    std::vector<std::uint32_t> sentence;
+    SentenceGenerator generator { g.grammar, GeneratorOptions { 2000, 12, 5 } };
+
+    generator.generate(
+        [&](Symbol *s) {
+            sentence.push_back(static_cast<std::uint32_t>(g.table.column(s).value()));
+
+            if (s != g.grammar.end())
+            {
+                return;
+            }
+
+            std::vector<ParseError> errors;
+
+            auto expected = parser.parse(std::span<const std::uint32_t> { sentence });
+            auto actual = parser.parse(sentence, recovery, errors);
+
+            EXPECT_TRUE(errors.empty());
+            EXPECT_EQ(expected.accepted, actual.accepted);
+            EXPECT_EQ(expected.reductions, actual.reductions);
+
+            for (std::size_t i = 0; i + 1 < sentence.size(); ++i)
+            {
+                auto broken = sentence;
+                broken.erase(broken.begin() + i);
+
+                errors.clear();
+                parser.parse(broken, recovery, errors);
+
+                for (const ParseError &error : errors)
+                {
+                    EXPECT_FALSE(recovery.expects(error.row, broken[error.position]));
+                }
+            }
+
+            sentence.clear();
+        });
+}
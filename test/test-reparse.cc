@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include "generate.hh"
+#include "input.hh"
+#include "reparse.hh"
+
+#include <array>
+#include <fstream>
+#include <random>
+
+using namespace lr1cc;
+
+struct ReparseGrammar
+{
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+    Grammar grammar;
+    ParseTable table;
+
+    explicit ReparseGrammar(const char *name)
+        : grammar { read(name) },
+          table { build() }
+    {
+    }
+
+    Grammar read(const char *name)
+    {
+        std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + name };
+        return parse_input(in, manager, productions);
+    }
+
+    ParseTable build()
+    {
+        grammar.calculate();
+        grammar.ensure_sanity();
+
+        return ParseTable { nfa_to_dfa(grammar_to_nfa(grammar)), table_columns(manager) };
+    }
+
+    std::uint32_t column(const char *name) const
+    {
+        return static_cast<std::uint32_t>(table.column(manager.get_symbol(name)).value());
+    }
+
+    // Sentences of the grammar joined into one input, which is again a
+    // sentence when the start symbol is a left-recursive list.
+    std::vector<std::uint32_t> document(std::size_t tokens, std::uint64_t seed)
+    {
+        std::vector<std::uint32_t> input;
+        SentenceGenerator generator { grammar, GeneratorOptions { tokens, 8, seed } };
+
+        generator.generate(
+            [&](Symbol *s) {
+                if (s != grammar.end())
+                {
+                    input.push_back(static_cast<std::uint32_t>(table.column(s).value()));
+                }
+            });
+
+        input.push_back(static_cast<std::uint32_t>(table.column(grammar.end()).value()));
+
+        return input;
+    }
+};
+
+static void write_tree(const IncrementalParser &parser, std::uint32_t index, std::vector<std::size_t> &out)
+{
+    const ParseNode &node = parser.node(index);
+
+    out.insert(out.end(), { node.symbol, reinterpret_cast<std::size_t>(node.production), node.state, node.length, node.children.size() });
+
+    for (std::uint32_t child : node.children)
+    {
+        write_tree(parser, child, out);
+    }
+}
+
+static std::vector<std::size_t> tree(const IncrementalParser &parser)
+{
+    std::vector<std::size_t> out;
+
+    if (parser.root().has_value())
+    {
+        write_tree(parser, parser.root().value(), out);
+    }
+
+    return out;
+}
+
+TEST(Reparse, Edit)
+{
+    ReparseGrammar g { "/lisp.grammar" };
+    IncrementalParser parser { g.table };
+
+    auto input = g.document(5000, 3);
+    auto full = parser.parse(input);
+
+    ASSERT_TRUE(full.accepted);
+    EXPECT_EQ(input.size() - 1, parser.node(parser.root().value()).length);
+
+    auto integer = g.column("integer");
+    auto symbol = g.column("symbol");
+    auto radix = std::array { g.column("sharp-b"), g.column("sharp-o"), g.column("sharp-x") };
+    auto middle = input.size() / 2;
+
+    while (middle < input.size() && (input[middle] != integer || std::ranges::find(radix, input[middle - 1]) != radix.end()))
+    {
+        ++middle;
+    }
+
+    ASSERT_LT(middle, input.size());
+
+    std::vector<std::uint32_t> replacement { symbol };
+    auto result = parser.edit(middle, middle + 1, replacement);
+
+    // The elements of the left-recursive list after the edit are
+    // shifted whole, but the list itself is reduced again.
+    EXPECT_TRUE(result.accepted);
+    EXPECT_LT(result.reductions * 2, full.reductions);
+
+    IncrementalParser fresh { g.table };
+
+    EXPECT_TRUE(fresh.parse(parser.tokens()).accepted);
+    EXPECT_EQ(tree(fresh), tree(parser));
+
+    std::vector<std::uint32_t> nil { g.column("sparen"), g.column("eparen") };
+    result = parser.edit(input.size() - 1, input.size() - 1, nil);
+
+    EXPECT_TRUE(result.accepted);
+    EXPECT_EQ(input.size() + 2, parser.tokens().size());
+    EXPECT_LT(result.reductions * 20, full.reductions);
+
+    result = parser.edit(0, 0, std::span { nil }.subspan(1));
+
+    EXPECT_FALSE(result.accepted);
+    EXPECT_EQ(0, result.position);
+    EXPECT_FALSE(parser.root().has_value());
+
+    result = parser.edit(0, 1, { });
+
+    EXPECT_TRUE(result.accepted);
+    EXPECT_TRUE(fresh.parse(parser.tokens()).accepted);
+    EXPECT_EQ(tree(fresh), tree(parser));
+
+    EXPECT_THROW(parser.edit(1, 0, { }), std::runtime_error);
+    EXPECT_THROW(parser.edit(0, parser.tokens().size() + 1, { }), std::runtime_error);
+}
+
+TEST(Reparse, RandomEdits)
+{
+    for (const char *name : { "/lisp.grammar", "/multi-start.grammar" })
+    {
+        ReparseGrammar g { name };
+        IncrementalParser parser { g.table };
+        IncrementalParser fresh { g.table };
+        LRParser reference { g.table };
+
+        auto input = g.document(600, 9);
+        auto terminals = static_cast<std::uint32_t>(std::ranges::count_if(g.table.columns(), [](Symbol *s) { return s->is_terminal(); }));
+
+        parser.parse(input);
+
+        std::mt19937_64 random { 17 };
+        std::size_t accepted = 0;
+
+        auto check = [&](const ParseResult &result) {
+            auto expected = reference.parse(std::span<const std::uint32_t> { parser.tokens() });
+
+            ASSERT_EQ(expected.accepted, result.accepted);
+            EXPECT_EQ(expected.position, result.position);
+
+            if (result.accepted)
+            {
+                ++accepted;
+                EXPECT_TRUE(fresh.parse(parser.tokens()).accepted);
+                EXPECT_EQ(tree(fresh), tree(parser));
+            }
+        };
+
+        for (int i = 0; i < 150; ++i)
+        {
+            const auto &tokens = parser.tokens();
+            auto begin = std::uniform_int_distribution<std::size_t> { 0, tokens.size() - 1 }(random);
+            auto end = std::min(tokens.size() - 1, begin + std::uniform_int_distribution<std::size_t> { 0, 3 }(random));
+
+            std::vector<std::uint32_t> removed { tokens.begin() + static_cast<std::ptrdiff_t>(begin), tokens.begin() + static_cast<std::ptrdiff_t>(end) };
+            std::vector<std::uint32_t> replacement;
+
+            if (i % 2 == 0)
+            {
+                replacement = removed;
+            }
+            else
+            {
+                for (auto n = std::uniform_int_distribution<int> { 0, 2 }(random); n > 0; --n)
+                {
+                    replacement.push_back(std::uniform_int_distribution<std::uint32_t> { 1, terminals - 1 }(random));
+                }
+            }
+
+            check(parser.edit(begin, end, replacement));
+            check(parser.edit(begin, begin + replacement.size(), removed));
+        }
+
+        EXPECT_LT(150, accepted);
+    }
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include "generate.hh"
+#include "input.hh"
+#include "runtime.hh"
+
+#include <algorithm>
+#include <fstream>
+
+using namespace lr1cc;
+
+TEST(Runtime, ParseBatch)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/lisp.grammar" };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    ParseTable table { nfa_to_dfa(grammar_to_nfa(g)), table_columns(manager) };
+    LRParser parser { table };
+
+    std::vector<std::vector<std::uint32_t>> sentences(1);
+    SentenceGenerator generator { g, GeneratorOptions { 20000, 10, 3 } };
+
+    generator.generate(
+        [&](Symbol *s) {
+            sentences.back().push_back(static_cast<std::uint32_t>(table.column(s).value()));
+
+            if (s != g.end())
+            {
+                return;
+            }
+
+            auto broken = sentences.back();
+
+            if (sentences.size() % 3 == 0)
+            {
+                broken.erase(broken.begin() + static_cast<std::ptrdiff_t>(broken.size() / 2));
+            }
+
+            sentences.back() = std::move(broken);
+            sentences.emplace_back();
+        });
+
+    sentences.pop_back();
+
+    std::vector<std::span<const std::uint32_t>> inputs { sentences.begin(), sentences.end() };
+
+    ASSERT_LT(1000, inputs.size());
+
+    for (std::size_t threads : { 1, 4, 0 })
+    {
+        auto results = parse_batch(table, inputs, threads);
+
+        ASSERT_EQ(inputs.size(), results.size());
+
+        for (std::size_t i = 0; i < inputs.size(); ++i)
+        {
+            ParseTree tree;
+            auto expected = parser.parse(inputs[i], tree);
+
+            EXPECT_EQ(expected.accepted, results[i].result.accepted);
+            EXPECT_EQ(expected.position, results[i].result.position);
+            EXPECT_EQ(expected.reductions, results[i].result.reductions);
+            EXPECT_EQ(tree, results[i].tree);
+        }
+    }
+
+    std::size_t accepted = 0;
+
+    for (const auto &[ result, tree ] : parse_batch(table, inputs, 4))
+    {
+        EXPECT_EQ(result.accepted, tree.root.has_value());
+
+        if (!result.accepted)
+        {
+            continue;
+        }
+
+        ++accepted;
+
+        const auto &root = tree.nodes[tree.root.value()];
+
+        EXPECT_EQ(g.start(), root.production->lhs);
+        EXPECT_EQ(0, root.begin);
+        EXPECT_EQ(result.position, root.length);
+        EXPECT_EQ(result.reductions, std::ranges::count_if(tree.nodes, [](const TreeNode &node) { return node.production != nullptr; }));
+
+        for (const TreeNode &node : tree.nodes)
+        {
+            auto begin = node.begin;
+
+            for (std::uint32_t child : tree.children_of(node))
+            {
+                EXPECT_EQ(begin, tree.nodes[child].begin);
+                begin += tree.nodes[child].length;
+            }
+
+            if (node.production != nullptr)
+            {
+                EXPECT_EQ(node.production->rhs.size(), node.child_count);
+                EXPECT_EQ(node.begin + node.length, begin);
+            }
+        }
+    }
+
+    EXPECT_LT(0, accepted);
+
+    EXPECT_TRUE(parse_batch(table, { }).empty());
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include "server.hh"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace lr1cc;
+
+static void write_file(const std::filesystem::path &path, std::string_view content)
+{
+    std::ofstream out { path, std::ios::binary };
+    out << content;
+}
+
+TEST(Server, Handle)
+{
+    auto directory = std::filesystem::temp_directory_path() / "lr1cc-test-server";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    auto path = (directory / "list.grammar").string();
+
+    write_file(path,
+        "%start S %end end %terminal x\n"
+        "%grammar S: x [one] | S x [more] ;\n");
+
+    Server server { Config { { }, false } };
+
+    auto first = server.handle("build " + path);
+    ASSERT_TRUE(first.starts_with("ok\n"));
+    EXPECT_NE(std::string::npos, first.find("\r\n"));
+    EXPECT_EQ(0, server.hits());
+    EXPECT_EQ(1, server.misses());
+
+    EXPECT_EQ(first, server.handle("build " + path));
+    EXPECT_EQ("ok\n", server.handle("check " + path));
+    EXPECT_EQ(2, server.hits());
+    EXPECT_EQ(1, server.misses());
+
+    write_file(path,
+        "%start S %end end %terminal x\n"
+        "%grammar S: x [one] | S S [more] ;\n");
+
+    auto conflict = server.handle("conflicts " + path);
+    EXPECT_TRUE(conflict.starts_with("conflict\n"));
+    EXPECT_NE(std::string::npos, conflict.find("detected."));
+    EXPECT_EQ(2, server.misses());
+
+    write_file(path, "%start S %end end\n%grammar S: x [one] ;\n");
+    EXPECT_TRUE(server.handle("build " + path).starts_with("error\nerror: "));
+
+    EXPECT_EQ("error\nerror: failed to open `" + (directory / "none").string() + "'.\n",
+              server.handle("build " + (directory / "none").string()));
+    EXPECT_TRUE(server.handle("frobnicate " + path).starts_with("error\n"));
+    EXPECT_TRUE(server.handle("build").starts_with("error\n"));
+
+    write_file(directory / "common.grammar", "%terminal x\n");
+    write_file(path,
+        "%start S %end end %include \"common.grammar\"\n"
+        "%grammar S: x [one] | S x [more] ;\n");
+
+    EXPECT_TRUE(server.handle("check " + path).starts_with("ok\n"));
+    EXPECT_TRUE(server.handle("check " + path).starts_with("ok\n"));
+    EXPECT_EQ(3, server.hits());
+
+    write_file(directory / "common.grammar", "%terminal y\n");
+    EXPECT_TRUE(server.handle("check " + path).starts_with("error\nerror: unknown symbol `x'"));
+    EXPECT_EQ(3, server.hits());
+
+    EXPECT_FALSE(server.is_stopping());
+    EXPECT_EQ("ok\n", server.handle("shutdown"));
+    EXPECT_TRUE(server.is_stopping());
+
+    std::filesystem::remove_all(directory);
+}
+
+static int connect_to(const std::string &path)
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+
+    for (int retry = 0; retry < 100; ++retry)
+    {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0)
+        {
+            return fd;
+        }
+
+        ::close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds { 10 });
+    }
+
+    return -1;
+}
+
+TEST(Server, Socket)
+{
+    auto directory = std::filesystem::temp_directory_path() / "lr1cc-test-server-socket";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    auto grammar = (directory / "list.grammar").string();
+    auto socket = (directory / "lr1cc.sock").string();
+
+    write_file(grammar,
+        "%start S %end end %terminal x\n"
+        "%grammar S: x [one] | S x [more] ;\n");
+
+    Server server { Config { { }, false } };
+    std::jthread thread { [&]() { serve(socket, server, 2); } };
+
+    int a = connect_to(socket);
+    int b = connect_to(socket);
+    ASSERT_LE(0, a);
+    ASSERT_LE(0, b);
+
+    ASSERT_TRUE(write_frame(a, "check " + grammar));
+    ASSERT_TRUE(write_frame(b, "build " + grammar));
+    EXPECT_EQ("ok\n", read_frame(a));
+    EXPECT_EQ(server.handle("build " + grammar), read_frame(b));
+
+    ::close(b);
+
+    ASSERT_TRUE(write_frame(a, "shutdown"));
+    EXPECT_EQ("ok\n", read_frame(a));
+
+    ::close(a);
+    thread.join();
+
+    EXPECT_FALSE(std::filesystem::exists(socket));
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "dfa.hh"
+#include "input.hh"
+#include "output.hh"
+#include "spill.hh"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace lr1cc;
+
+TEST(Spill, Intern)
+{
+    StateSetStore store { std::filesystem::temp_directory_path(), 8 };
+
+    std::vector<std::string> strings;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        strings.push_back("set " + std::to_string(i));
+    }
+
+    for (std::size_t i = 0; i < strings.size(); ++i)
+    {
+        EXPECT_EQ((std::pair { i, true }), store.intern(strings[i]));
+    }
+
+    EXPECT_EQ(strings.size(), store.size());
+
+    for (std::size_t i = 0; i < strings.size(); ++i)
+    {
+        EXPECT_EQ((std::pair { i, false }), store.intern(strings[i]));
+        EXPECT_EQ(strings[i], store.get(i));
+    }
+
+    EXPECT_LT(0, store.reads());
+
+    EXPECT_EQ((std::pair { strings.size(), true }), store.intern(""));
+    EXPECT_EQ(strings.size() + 1, store.size());
+    EXPECT_EQ((std::pair { strings.size(), false }), store.intern(""));
+    EXPECT_EQ("", store.get(strings.size()));
+
+}
+
+TEST(Spill, Directory)
+{
+    auto directory = std::filesystem::temp_directory_path() / "lr1cc-test-spill";
+    std::filesystem::remove_all(directory);
+
+    {
+        StateSetStore store { (directory / "a" / "b").string(), 8 };
+
+        EXPECT_EQ((std::pair { std::size_t { 0 }, true }), store.intern("set"));
+        EXPECT_EQ("set", store.get(0));
+    }
+
+    EXPECT_TRUE(std::filesystem::is_directory(directory / "a" / "b"));
+
+    std::ofstream { directory / "file" } << "not a directory";
+
+    EXPECT_THROW((StateSetStore { (directory / "file" / "a").string(), 8 }), std::runtime_error);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(Spill, Construction)
+{
+    for (const char *name : { "/lisp.grammar", "/non-lalr.grammar", "/arithmetic.grammar" })
+    {
+        std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + name };
+
+        SymbolManager manager;
+        std::vector<std::unique_ptr<Production>> productions;
+
+        auto g = parse_input(in, manager, productions);
+        g.calculate();
+        g.ensure_sanity();
+
+        auto nfa = grammar_to_nfa(g);
+        auto columns = table_columns(manager);
+
+        StateSetStore store { std::filesystem::temp_directory_path(), 64 };
+        auto dfa = nfa_to_dfa(nfa, store);
+
+        EXPECT_EQ(lr1_table_rows(nfa_to_dfa(nfa), columns), lr1_table_rows(dfa, columns));
+        EXPECT_EQ(std::ranges::distance(dfa.states()), store.size());
+    }
+}
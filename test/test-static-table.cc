@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include "generate.hh"
+#include "input.hh"
+#include "output.hh"
+#include "runtime.hh"
+#include "static-table.hh"
+
+#include <fstream>
+
+using namespace lr1cc;
+
+static constexpr StaticProduction arithmetic[] = {
+    { "addition", "AddExpr", "AddExpr plus MulExpr" },
+    { "subtraction", "AddExpr", "AddExpr minus MulExpr" },
+    { "sole-mul-expr", "AddExpr", "MulExpr" },
+    { "multiplication", "MulExpr", "MulExpr mul UnaryExpr" },
+    { "division", "MulExpr", "MulExpr div UnaryExpr" },
+    { "sole-unary-expr", "MulExpr", "UnaryExpr" },
+    { "position", "UnaryExpr", "plus UnaryExpr" },
+    { "negation", "UnaryExpr", "minus UnaryExpr" },
+    { "sole-primary-expr", "UnaryExpr", "PrimaryExpr" },
+    { "number", "PrimaryExpr", "number" },
+    { "variable", "PrimaryExpr", "ident" },
+    { "subexpr", "PrimaryExpr", "sparen AddExpr eparen" },
+};
+
+static constexpr auto arithmetic_table = make_static_table([] {
+    return StaticGrammar { "AddExpr", "end", arithmetic };
+});
+
+static constexpr StaticProduction ambiguous[] = {
+    { "sum", "E", "E plus E" },
+    { "num", "E", "num" },
+};
+
+static constexpr StaticProduction nullable[] = {
+    { "more-ab", "S", "a S b" },
+    { "no-more-ab", "S", "" },
+    { "list", "L", "S semicolon L" },
+    { "last", "L", "S" },
+};
+
+static constexpr auto nullable_table = make_static_table([] {
+    return StaticGrammar { "L S", "end", nullable };
+});
+
+static_assert(arithmetic_table.terminals == 9);
+static_assert(arithmetic_table.nonterminals == 4);
+static_assert(arithmetic_table.symbols[0] == "end");
+static_assert(arithmetic_table.action(0, 0).type == CellType::error);
+static_assert(static_conflicts(StaticGrammar { "AddExpr", "end", arithmetic }) == 0);
+static_assert(static_conflicts(StaticGrammar { "E", "end", ambiguous }) > 0);
+static_assert(nullable_table.starts.size() == 2);
+
+// A parser over the dense arrays alone.
+template <typename Table>
+static ParseResult static_parse(const Table &table, const std::vector<std::uint32_t> &input, std::size_t entry = 0)
+{
+    ParseResult result { false, 0, 0 };
+    std::vector<std::uint32_t> stack { static_cast<std::uint32_t>(entry) };
+
+    while (result.position < input.size())
+    {
+        const ActionCell &cell = table.action(stack.back(), input[result.position]);
+
+        switch (cell.type)
+        {
+        case CellType::error:
+            return result;
+        case CellType::accept:
+            result.accepted = true;
+            return result;
+        case CellType::shift:
+            stack.push_back(cell.value);
+            ++result.position;
+            break;
+        case CellType::reduce:
+        {
+            const StaticRule &rule = table.productions[cell.value];
+            stack.resize(stack.size() - rule.length);
+            stack.push_back(table.go(stack.back(), rule.lhs - table.terminals));
+            ++result.reductions;
+            break;
+        }
+        }
+    }
+
+    return result;
+}
+
+TEST(StaticTable, Arithmetic)
+{
+    std::ifstream in { std::string { LR1CC_SAMPLE_DIR } + "/arithmetic.grammar" };
+
+    SymbolManager manager;
+    std::vector<std::unique_ptr<Production>> productions;
+
+    auto g = parse_input(in, manager, productions);
+    g.calculate();
+    g.ensure_sanity();
+
+    ParseTable table { nfa_to_dfa(grammar_to_nfa(g)), table_columns(manager) };
+    LRParser parser { table };
+
+    EXPECT_EQ(table.rows(), arithmetic_table.rows);
+
+    for (std::size_t i = 0; i < g.productions().size(); ++i)
+    {
+        EXPECT_EQ(g.productions()[i]->name, arithmetic_table.productions[i].name);
+    }
+
+    std::vector<Symbol *> sentence;
+    SentenceGenerator generator { g, GeneratorOptions { 3000, 12, 11 } };
+
+    generator.generate(
+        [&](Symbol *s) {
+            sentence.push_back(s);
+
+            if (s != g.end())
+            {
+                return;
+            }
+
+            for (std::size_t i = 0; i <= sentence.size(); ++i)
+            {
+                auto broken = sentence;
+
+                if (i < broken.size())
+                {
+                    broken.erase(broken.begin() + i);
+                }
+
+                std::vector<std::uint32_t> tokens;
+
+                for (Symbol *t : broken)
+                {
+                    tokens.push_back(static_cast<std::uint32_t>(arithmetic_table.symbol(t->name()).value()));
+                }
+
+                auto expected = parser.parse(std::span { broken });
+                auto actual = static_parse(arithmetic_table, tokens);
+
+                EXPECT_EQ(expected.accepted, actual.accepted);
+                EXPECT_EQ(expected.position, actual.position);
+                EXPECT_EQ(expected.reductions, actual.reductions);
+            }
+
+            sentence.clear();
+        });
+}
+
+TEST(StaticTable, Nullable)
+{
+    auto token = [](std::string_view name) {
+        return static_cast<std::uint32_t>(nullable_table.symbol(name).value());
+    };
+
+    auto a = token("a"), b = token("b"), semicolon = token("semicolon"), end = token("end");
+
+    EXPECT_TRUE(static_parse(nullable_table, { end }).accepted);
+    EXPECT_TRUE(static_parse(nullable_table, { a, b, semicolon, a, a, b, b, end }).accepted);
+    EXPECT_FALSE(static_parse(nullable_table, { a, b, semicolon, a, a, b, b, end }, 1).accepted);
+    EXPECT_TRUE(static_parse(nullable_table, { a, a, b, b, end }, 1).accepted);
+    EXPECT_FALSE(static_parse(nullable_table, { a, b, b, end }, 1).accepted);
+}
+
+TEST(StaticTable, RunTimeErrors)
+{
+    StaticGrammar undefined_start { "X", "end", arithmetic };
+    StaticGrammar end_on_lhs { "E", "E", ambiguous };
+
+    EXPECT_THROW(static_table_shape(undefined_start), std::runtime_error);
+    EXPECT_THROW(static_table_shape(end_on_lhs), std::runtime_error);
+}
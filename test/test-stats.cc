@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "stats.hh"
+
+#include <sstream>
+#include <unordered_map>
+
+using namespace lr1cc;
+
+TEST(Stats, HashTable)
+{
+    std::unordered_map<int, int> table;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        table.emplace(i, i);
+    }
+
+    auto stats = hash_table_stats(table);
+
+    EXPECT_EQ(100, stats.size);
+    EXPECT_EQ(table.bucket_count(), stats.bucket_count);
+    EXPECT_FLOAT_EQ(table.load_factor(), stats.load_factor);
+    EXPECT_LT(stats.collisions, 100);
+}
+
+TEST(Stats, Automata)
+{
+    Symbol symbols[] = {
+        { "x", SymbolType::terminal },
+        { "y", SymbolType::terminal },
+        { "S", SymbolType::intermediate }
+    };
+
+    Production p { "p", symbols + 2, std::vector { symbols + 0 } };
+
+    NFAState n_reject { Acceptance { AcceptanceType::reject, nullptr } };
+    NFAState n_reduce { Acceptance { AcceptanceType::reduce, &p } };
+
+    DFA dfa;
+
+    auto d_start = dfa.create_state(std::vector { &n_reject });
+    auto d_mid_1 = dfa.create_state(std::vector { &n_reject });
+    auto d_mid_2 = dfa.create_state(std::vector { &n_reject });
+    auto d_r = dfa.create_state(std::vector { &n_reduce });
+
+    dfa.set_start(d_start);
+
+    d_start->transitions().emplace(symbols + 0, d_mid_1);
+    d_start->transitions().emplace(symbols + 1, d_mid_2);
+    d_mid_1->transitions().emplace(symbols + 0, d_r);
+    d_mid_2->transitions().emplace(symbols + 0, d_r);
+
+    auto automaton = dfa_stats(dfa);
+
+    EXPECT_EQ(4, automaton.states);
+    EXPECT_EQ(4, automaton.transitions);
+
+    std::vector columns { symbols + 0, symbols + 1, symbols + 2 };
+
+    auto table = lr1_table_stats(dfa, columns);
+
+    EXPECT_EQ(3, table.rows);
+    EXPECT_EQ(3, table.columns);
+    EXPECT_EQ(4, table.filled_cells);
+    EXPECT_EQ(2, table.distinct_rows);
+}
+
+TEST(Stats, Output)
+{
+    Stats stats {};
+    stats.phases.push_back(PhaseTiming { "parse", 0.5, 0.25 });
+    stats.dfa = AutomatonStats { 3, 2 };
+
+    std::ostringstream json;
+    output_stats_json(stats, json);
+
+    EXPECT_NE(std::string::npos, json.str().find("{\"name\":\"parse\",\"wall\":0.5,\"cpu\":0.25}"));
+    EXPECT_NE(std::string::npos, json.str().find("\"dfa\":{\"states\":3,\"transitions\":2}"));
+
+    std::ostringstream text;
+    output_stats(stats, text);
+
+    EXPECT_NE(std::string::npos, text.str().find("dfa: 3 states, 2 transitions"));
+}
+
+TEST(Stats, JsonEscape)
+{
+    Stats stats {};
+    stats.input = "C:\\grammars\\\"quoted\"\n.grammar";
+    stats.construction = "lr1";
+    stats.phases.push_back(PhaseTiming { "a\"b\\c\x01", 0.5, 0.25 });
+
+    std::ostringstream json;
+    output_stats_json(stats, json);
+
+    EXPECT_NE(std::string::npos, json.str().find("{\"input\":\"C:\\\\grammars\\\\\\\"quoted\\\"\\n.grammar\",\"construction\":\"lr1\","));
+    EXPECT_NE(std::string::npos, json.str().find("{\"name\":\"a\\\"b\\\\c\\u0001\",\"wall\":0.5,"));
+}
@@ -96,11 +96,27 @@ TEST(Symbols, First)
     b.first().emplace(&y);
     c.first().emplace(&y);
 
-    std::set<Symbol *> expect_abz { &x, &y, &z };
+    First expect_abz { &x, &y, &z };
     EXPECT_EQ(expect_abz, first(std::vector { &a, &b, &z }));
     EXPECT_EQ(expect_abz, first(std::vector { &a, &b }, &z));
 
-    std::set<Symbol *> expect_acz { &x, &y };
+    First expect_acz { &x, &y };
     EXPECT_EQ(expect_acz, first(std::vector { &a, &c, &z }));
     EXPECT_EQ(expect_acz, first(std::vector { &a, &c }, &z));
 }
+
+TEST(Symbols, DeclarationOrder)
+{
+    SymbolManager manager;
+
+    std::vector<Symbol *> declared;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        declared.push_back(manager.create_symbol("s" + std::to_string(i), SymbolType::terminal));
+    }
+
+    First ordered { declared.rbegin(), declared.rend() };
+
+    EXPECT_TRUE(std::ranges::equal(declared, ordered));
+}